@@ -0,0 +1,79 @@
+/* a C program running lispy through lispy.h: it adds a builtin,
+reads a form once and evaluates it many times, and looks at the
+results without copying them. run it from the repo, which has
+library.lspy */
+#include <stdio.h>
+#include <time.h>
+#include "lispy.h"
+
+/* (total {1 2 3} 4 ...) adds up numbers and lists of numbers */
+lval* host_total(lenv* e,lval* a){
+    lispy* l=lispy_of(e);
+    long total=0;
+    for(int i=0;i<lispy_count(a);i++){
+        lval* v=lispy_cell(a,i);
+        if(lispy_type(v)==LVAL_NUM){
+            total+=lispy_num(v);
+            continue;
+        }
+        if(lispy_type(v)!=LVAL_QEXPR){
+            lval_del(a);
+            return lval_err(l,"Function 'total' passed a non-number!");
+        }
+        for(int j=0;j<lispy_count(v);j++){
+            lval* x=lispy_cell(v,j);
+            if(lispy_type(x)!=LVAL_NUM){
+                lval_del(a);
+                return lval_err(l,"Function 'total' passed a non-number!");
+            }
+            total+=lispy_num(x);
+        }
+    }
+    lval_del(a);
+    return lval_num(l,total);
+}
+
+/* print a result, or the error in it, and free it */
+void host_show(lval* v){
+    if(lispy_type(v)==LVAL_ERR) printf("Error:%s\n",lispy_str(v));
+    else if(lispy_type(v)==LVAL_NUM) printf("%ld\n",lispy_num(v));
+    else if(lispy_type(v)==LVAL_STR) printf("%s\n",lispy_str(v));
+    else printf("(%d values)\n",lispy_count(v));
+    lval_del(v);
+}
+
+int main(int argc,char** argv){
+    lispy* l=lispy_new();
+    lispy_add_builtin(l,"total",host_total);
+    host_show(lispy_load(l,"library.lspy"));
+    host_show(lispy_eval_string(l,"(fun {square x} {* x x})"));
+    host_show(lispy_eval_string(l,"(total {1 2 3} 4)"));
+    host_show(lispy_eval_string(l,"(total {1 \"two\"})"));
+    host_show(lispy_eval_string(l,"(total"));
+
+    /* reading is done once, each evaluation only copies the forms */
+    char* src="(total {1 2 3 4 5 6 7 8} (square 9))";
+    long n=100000,sum=0;
+    lval* form=lispy_read(l,src);
+    clock_t start=clock();
+    for(long i=0;i<n;i++){
+        lval* v=lispy_eval_form(l,form);
+        sum+=lispy_num(v);
+        lval_del(v);
+    }
+    double formed=(double)(clock()-start)/CLOCKS_PER_SEC;
+    start=clock();
+    for(long i=0;i<n;i++){
+        lval* v=lispy_eval_string(l,src);
+        sum+=lispy_num(v);
+        lval_del(v);
+    }
+    double stringed=(double)(clock()-start)/CLOCKS_PER_SEC;
+    lval_del(form);
+    printf("%ld evaluations: %.3fs read once, %.3fs read each time (%ld)\n",
+        n,formed,stringed,sum);
+
+    lispy_flush(l);
+    lispy_free(l);
+    return 0;
+}
@@ -0,0 +1,88 @@
+/* how fast the lispy grammar reads large sources made up of long
+runs of comments, strings, symbols and blanks. build it once as it
+is and once with -DMPC_SCAN_SCALAR to see what the vector scans in
+mpc.c are worth. the size of each source in megabytes may be given,
+8 by default */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mpc.h"
+
+char* scan_grammar=
+    "                                                           \
+        number:     /-?[0-9]+/ ;                                \
+        symbol:     /[a-zA-Z0-9_+\\-*\\/\\\\=<>!&]+/ ;          \
+        string:     /\"(\\\\.|[^\"])*\"/ ;                      \
+        comment:    /;[^\\r\\n]*/ ;                             \
+        sexpr:      '(' <expr>* ')' ;                           \
+        qexpr:      '{' <expr>* '}';                            \
+        expr:       <number> | <symbol> | <string> |            \
+                    <comment> | <sexpr> | <qexpr>;              \
+        lispy:      /^/ <expr>* /$/ ;                           \
+    ";
+
+/* a source of about size bytes, made of head, run bytes of fill and
+tail over and over */
+char* scan_source(long size,char* head,char fill,long run,char* tail){
+    long hn=strlen(head),tn=strlen(tail),n=0;
+    char* s=malloc(size+hn+run+tn+1);
+    while(n<size){
+        memcpy(s+n,head,hn);
+        n+=hn;
+        memset(s+n,fill,run);
+        n+=run;
+        memcpy(s+n,tail,tn);
+        n+=tn;
+    }
+    s[n]='\0';
+    return s;
+}
+
+/* the best of a few parses, in megabytes a second */
+double scan_time(mpc_parser_t* p,char* src){
+    double best=0;
+    long n=strlen(src);
+    for(int k=0;k<5;k++){
+        mpc_result_t r;
+        clock_t start=clock();
+        int ok=mpc_parse_arena("<scan>",src,p,&r);
+        double t=(double)(clock()-start)/CLOCKS_PER_SEC;
+        if(ok) mpc_ast_delete(r.output);
+        else {
+            mpc_err_print(r.error);
+            mpc_err_delete(r.error);
+            return 0;
+        }
+        if(k==0||t<best) best=t;
+    }
+    return best>0?n/best/1e6:0;
+}
+
+int main(int argc,char** argv){
+    long size=(argc>1?atol(argv[1]):8)*1000000;
+    mpc_parser_t* Number=mpc_new("number");
+    mpc_parser_t* Symbol=mpc_new("symbol");
+    mpc_parser_t* String=mpc_new("string");
+    mpc_parser_t* Comment=mpc_new("comment");
+    mpc_parser_t* Sexpr=mpc_new("sexpr");
+    mpc_parser_t* Qexpr=mpc_new("qexpr");
+    mpc_parser_t* Expr=mpc_new("expr");
+    mpc_parser_t* Lispy=mpc_new("lispy");
+    mpca_lang(MPCA_LANG_DEFAULT,scan_grammar,
+        Number,Symbol,String,Comment,Sexpr,Qexpr,Expr,Lispy);
+
+    char* names[]={"comments","strings","symbols","blanks"};
+    char* srcs[4];
+    srcs[0]=scan_source(size,"; ",'c',400,"\n");
+    srcs[1]=scan_source(size,"\"",'s',400,"\\\"\" ");
+    srcs[2]=scan_source(size,"(",'y',400,")");
+    srcs[3]=scan_source(size,"{1",' ',400,"}");
+    for(int k=0;k<4;k++){
+        printf("%-8s %8.1f MB/s\n",names[k],scan_time(Lispy,srcs[k]));
+        free(srcs[k]);
+    }
+
+    mpc_cleanup(8,Number,Symbol,String,Comment,Sexpr,Qexpr,Expr,Lispy);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/* parsing with one frozen grammar from many threads at once. each
+thread parses the same sources over and over, in turn as a plain
+parse, an arena parse and a parse with its own context, and checks
+every result against the one parsed before the threads started.
+half the threads keep their context to a smaller maximum depth, which
+the others must not see. build with -fsanitize=thread to look for
+races too */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "mpc.h"
+
+#define THREADS_DEPTH 256
+
+char* threads_grammar=
+    "                                                           \
+        number:     /-?[0-9]+/ ;                                \
+        symbol:     /[a-zA-Z0-9_+\\-*\\/\\\\=<>!&]+/ ;          \
+        string:     /\"(\\\\.|[^\"])*\"/ ;                      \
+        comment:    /;[^\\r\\n]*/ ;                             \
+        sexpr:      '(' <expr>* ')' ;                           \
+        qexpr:      '{' <expr>* '}';                            \
+        expr:       <number> | <symbol> | <string> |            \
+                    <comment> | <sexpr> | <qexpr>;              \
+        lispy:      /^/ <expr>* /$/ ;                           \
+    ";
+
+mpc_parser_t* Lispy;
+char* sources[8];
+int nsources=0;
+/* what each source parses to, with the full and the smaller depth */
+mpc_result_t full[8],shallow[8];
+int full_ok[8],shallow_ok[8];
+long parses=1000;
+
+/* a source nested n deep, too deep for THREADS_DEPTH when n is 100 */
+char* threads_nested(int n){
+    char* s=malloc(2*n+8);
+    char* p=s;
+    for(int i=0;i<n;i++) *p++='(';
+    p+=sprintf(p,"+ 1");
+    for(int i=0;i<n;i++) *p++=')';
+    *p='\0';
+    return s;
+}
+
+/* 1 if a parse gave the same as the one it is checked against */
+int threads_same(int ok,mpc_result_t* r,int want_ok,mpc_result_t* want){
+    if(ok!=want_ok) return 0;
+    if(ok) return mpc_ast_eq(r->output,want->output);
+    char* a=mpc_err_string(r->error);
+    char* b=mpc_err_string(want->error);
+    int same=strcmp(a,b)==0;
+    free(a);
+    free(b);
+    return same;
+}
+void threads_result_del(int ok,mpc_result_t* r){
+    if(ok) mpc_ast_delete(r->output);
+    else mpc_err_delete(r->error);
+}
+
+void* threads_run(void* arg){
+    long id=(long)arg,wrong=0;
+    mpc_context_t* c=mpc_context_new();
+    if(id%2) mpc_context_set_max_depth(c,THREADS_DEPTH);
+    for(long i=0;i<parses;i++){
+        int k=i%nsources,ok;
+        mpc_result_t r;
+        mpc_result_t* want=&full[k];
+        int want_ok=full_ok[k];
+        switch(i%3){
+        case 0: ok=mpc_parse("<threads>",sources[k],Lispy,&r); break;
+        case 1: ok=mpc_parse_arena("<threads>",sources[k],Lispy,&r); break;
+        default:
+            ok=(i/3)%2?mpc_context_parse_arena(c,"<threads>",sources[k],Lispy,&r)
+                :mpc_context_parse(c,"<threads>",sources[k],Lispy,&r);
+            if(id%2){
+                want=&shallow[k];
+                want_ok=shallow_ok[k];
+            }
+        }
+        if(!threads_same(ok,&r,want_ok,want)) wrong++;
+        threads_result_del(ok,&r);
+    }
+    mpc_context_delete(c);
+    return (void*)wrong;
+}
+
+int main(int argc,char** argv){
+    int n=argc>1?atoi(argv[1]):8;
+    if(argc>2) parses=atol(argv[2]);
+    if(n<1) n=1;
+
+    mpc_parser_t* Number=mpc_new("number");
+    mpc_parser_t* Symbol=mpc_new("symbol");
+    mpc_parser_t* String=mpc_new("string");
+    mpc_parser_t* Comment=mpc_new("comment");
+    mpc_parser_t* Sexpr=mpc_new("sexpr");
+    mpc_parser_t* Qexpr=mpc_new("qexpr");
+    mpc_parser_t* Expr=mpc_new("expr");
+    Lispy=mpc_new("lispy");
+    mpca_lang(MPCA_LANG_DEFAULT,threads_grammar,
+        Number,Symbol,String,Comment,Sexpr,Qexpr,Expr,Lispy);
+    mpc_freeze(Lispy);
+    if(mpc_define(Number,mpc_char('x'))){
+        printf("a frozen parser was defined again\n");
+        return 1;
+    }
+
+    sources[nsources++]="(def {fib} (\\ {n} {if (< n 2) {n} {+ (fib (- n 1)) (fib (- n 2))}})) (fib 15)";
+    sources[nsources++]="; a comment\n(print \"a \\\"string\\\"\" {1 -2 {3}})";
+    sources[nsources++]="(+ 1 (* 2 3)";
+    sources[nsources++]="{a b} } (c)";
+    sources[nsources++]=threads_nested(20);
+    sources[nsources++]=threads_nested(100);
+    mpc_context_t* c=mpc_context_new();
+    mpc_context_set_max_depth(c,THREADS_DEPTH);
+    for(int k=0;k<nsources;k++){
+        full_ok[k]=mpc_parse("<threads>",sources[k],Lispy,&full[k]);
+        shallow_ok[k]=mpc_context_parse(c,"<threads>",sources[k],Lispy,&shallow[k]);
+    }
+    mpc_context_delete(c);
+
+    pthread_t* t=malloc(sizeof(pthread_t)*n);
+    for(long i=0;i<n;i++) pthread_create(&t[i],NULL,threads_run,(void*)i);
+    long wrong=0;
+    for(int i=0;i<n;i++){
+        void* w;
+        pthread_join(t[i],&w);
+        wrong+=(long)w;
+    }
+    free(t);
+    printf("%d threads, %ld parses each, %ld differed\n",n,parses,wrong);
+
+    for(int k=0;k<nsources;k++){
+        threads_result_del(full_ok[k],&full[k]);
+        threads_result_del(shallow_ok[k],&shallow[k]);
+    }
+    free(sources[4]);
+    free(sources[5]);
+    mpc_cleanup(8,Number,Symbol,String,Comment,Sexpr,Qexpr,Expr,Lispy);
+    return wrong!=0;
+}
@@ -1,7 +1,13 @@
+/* sockets, processes and timers are posix, which -std=c99 hides */
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
 #include "mpc.h"
+#include "lispy.h"
+#include "lispy_grammar.h"
 #define LASSERT(args,cond,fmt,...) \
     if(!(cond)) {\
-        lval* err=lval_err(fmt,##__VA_ARGS__);\
+        lval* err=lval_err(e->l,fmt,##__VA_ARGS__);\
         lval_del(args);\
         return err;\
     }
@@ -24,10 +30,10 @@
 /* ; ? need ? */
 #ifdef _WIN32
 
-static char buffer[2048];
 /* fake readline function */
 char *readline(char *prompt)
 {
+    char buffer[2048];
     fputs(prompt, stdout);
     fgets(buffer, 2048, stdin);
     char *cpy = malloc(strlen(buffer) + 1);
@@ -41,26 +47,134 @@ void add_history(char *unused) {}
 #include <editline/readline.h>
 #include <editline/history.h>
 #endif
+#include <pthread.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#define mkdir(path,mode) _mkdir(path)
+#define getpid _getpid
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* forward declarations(to resolve cyclic types), with the
+public ones in lispy.h */
+struct lload_pool;
+typedef struct lload_pool lload_pool;
+
+/* a growable byte buffer, for printing and for values in binary */
+typedef struct {
+    char* data;
+    long len,cap;
+} lbuf;
+
+/* the grammar, compiled to a table and a parser in lispy_grammar.h by --grammar-table */
+char* lispy_grammar=
+    "                                                           \
+        number:     /-?[0-9]+/ ;                                \
+        symbol:     /[a-zA-Z0-9_+\\-*\\/\\\\=<>!&]+/ ;          \
+        string:     /\"(\\\\.|[^\"])*\"/ ;                      \
+        comment:    /;[^\\r\\n]*/ ;                             \
+        sexpr:      '(' <expr>* ')' ;                           \
+        qexpr:      '{' <expr>* '}';                            \
+        expr:       <number> | <symbol> | <string> |            \
+                    <comment> | <sexpr> | <qexpr>;              \
+        lispy:      /^/ <expr>* /$/ ;                           \
+    ";
+
+/* FNV-1a, kept to 32 bits so every platform agrees */
+unsigned long lispy_grammar_hash(char* s){
+    unsigned long h=2166136261UL;
+    while(*s){
+        h=((h^(unsigned char)*s++)*16777619UL)&0xffffffffUL;
+    }
+    return h;
+}
+
+/* the parsers of an interpreter */
+typedef struct {
+    mpc_parser_t* Number;
+    mpc_parser_t* Symbol;
+    mpc_parser_t* String;
+    mpc_parser_t* Comment;
+    mpc_parser_t* Sexpr;
+    mpc_parser_t* Qexpr;
+    mpc_parser_t* Expr;
+    mpc_parser_t* Lispy;
+    /* loaded from the table, which matches the grammar */
+    int current;
+} lgrammar;
+
+void lgrammar_new(lgrammar* g){
+    g->Number = mpc_new("number");
+    g->Symbol = mpc_new("symbol");
+    g->String =mpc_new("string");
+    g->Comment =mpc_new("comment");
+    g->Sexpr = mpc_new("sexpr");
+    g->Qexpr = mpc_new("qexpr");
+    g->Expr = mpc_new("expr");
+    g->Lispy = mpc_new("lispy");
+    g->current=0;
+}
+void lgrammar_del(lgrammar* g){
+    mpc_cleanup(8,g->Number,g->Symbol,g->String,g->Comment,
+        g->Sexpr,g->Qexpr,g->Expr,g->Lispy);
+}
+
+/* load the parsers from the table unless the grammar changed since,
+then freeze them so they stay as they are while being parsed with */
+void lispy_grammar_define(lgrammar* g){
+    mpc_err_t* err=NULL;
+    if(lispy_grammar_hash(lispy_grammar)==LISPY_GRAMMAR_HASH){
+        err=mpca_table(lispy_grammar_table,sizeof(lispy_grammar_table),
+            8, g->Number, g->Symbol, g->String, g->Comment,
+            g->Sexpr, g->Qexpr, g->Expr, g->Lispy);
+        if(!err) g->current=1;
+        else mpc_err_delete(err);
+    }
+    if(!g->current) mpca_lang(MPCA_LANG_DEFAULT,lispy_grammar,
+        g->Number, g->Symbol, g->String, g->Comment,
+        g->Sexpr, g->Qexpr, g->Expr, g->Lispy);
+    mpc_freeze(g->Lispy);
+    mpc_freeze(g->Comment);
+}
+
+/* always from the grammar, never the table being replaced */
+int lispy_grammar_write(char* filename){
+    FILE* f=fopen(filename,"w");
+    if(!f){
+        printf("%s: error: Unable to open file!\n",filename);
+        return 0;
+    }
+    lgrammar g;
+    lgrammar_new(&g);
+    mpca_lang(MPCA_LANG_DEFAULT,lispy_grammar,
+        g.Number, g.Symbol, g.String, g.Comment, g.Sexpr, g.Qexpr, g.Expr, g.Lispy);
+    fprintf(f,"/* generated by lispy --grammar-table, do not edit */\n");
+    fprintf(f,"#define LISPY_GRAMMAR_HASH 0x%08lxUL\n",lispy_grammar_hash(lispy_grammar));
+    mpc_err_t* err=mpca_table_source(f,"lispy_grammar_table",
+        8, g.Number, g.Symbol, g.String, g.Comment, g.Sexpr, g.Qexpr, g.Expr, g.Lispy);
+    if(!err){
+        fputc('\n',f);
+        err=mpca_codegen(f,"lispy_grammar_parse",g.Lispy);
+    }
+    fclose(f);
+    lgrammar_del(&g);
+    if(err){
+        mpc_err_print(err);
+        mpc_err_delete(err);
+        return 0;
+    }
+    return 1;
+}
+
 
-/* forward declarations(to resolve cyclic types) */
-struct lval;
-struct lenv;
-typedef struct lval lval;
-typedef struct lenv lenv;
-typedef lval*(*lbuiltin)(lenv*,lval*);
-
-mpc_parser_t* Number;
-mpc_parser_t* Symbol;
-mpc_parser_t* String;
-mpc_parser_t* Comment;
-mpc_parser_t* Sexpr;
-mpc_parser_t* Qexpr;
-mpc_parser_t* Expr;
-mpc_parser_t* Lispy;
-
-
-enum {LVAL_ERR,LVAL_NUM,LVAL_SYM,LVAL_STR,
-    LVAL_FUN,LVAL_SEXPR,LVAL_QEXPR};
 struct lval{
     int type;
     //basic
@@ -78,23 +192,60 @@ struct lval{
     struct lval** cell;
 };
 struct lenv{
+    lispy* l;
     lenv* par;
+    /* def stops here rather than at the outermost env */
+    int top;
     int count;
     char** syms;
     lval** vals;
 };
+/* why an evaluation is ending */
+enum {LSTOP_STEPS=1,LSTOP_BYTES,LSTOP_TIME,LSTOP_INTERRUPT};
+/* an interpreter: its grammar and reader, its global environment,
+where it prints, and what it has allocated and evaluated. nothing it
+changes as it runs is outside it, so threads can each run their own */
+struct lispy{
+    lgrammar grammar;
+    /* reused by every parse, so reading a line sets nothing up */
+    mpc_context_t* reader;
+    int read_with_mpc;
+    /* reads files on other threads, with --jobs */
+    lload_pool* loader;
+    char* cache_dir;
+    lenv* env;
+    /* standard output is written from out in large pieces */
+    lbuf out;
+    /* while set, out keeps everything, for the server to send it back */
+    int out_hold;
+    /* stats */
+    long allocs,bytes;
+    long evals,calls;
+    /* limits on each top-level evaluation, 0 for none, and while it
+    runs the steps left in the current slice of fuel and after it, the
+    bytes left, and when to stop */
+    long max_steps,max_bytes,max_ms;
+    long fuel,steps,room;
+    double deadline;
+    int depth;
+    int stop;
+    /* set from a signal handler or another thread to end the evaluation */
+    volatile sig_atomic_t interrupt;
+};
 /* prototypes */
-void lval_print(lval* v);
+void lval_print(lispy* l,lval* v);
 lval* lval_eval(lenv* e,lval* v);
 lval* builtin(lenv* e,lval* a, char* func);
 void lenv_del(lenv* e);
-lval* lval_copy(lval* v);
+lval* lval_copy(lispy* l,lval* v);
 lval* builtin(lenv* e,lval* a, char* func);
 lval* lval_call(lenv* e,lval* f,lval* a);
 lenv* lenv_copy(lenv* e);
 lval* builtin_eval(lenv* e,lval* a);
 lval* builtin_list(lenv* e,lval* a);
-void lval_print(lval* v);
+void lval_print(lispy* l,lval* v);
+char* lbuiltin_name(lbuiltin func);
+lbuiltin lbuiltin_find(char* name);
 
 /* return name */
 char* ltype_name(int t){
@@ -110,76 +261,106 @@ char* ltype_name(int t){
     }
 }
 /* constructors */
-lenv* lenv_new(){
-    lenv* e=malloc(sizeof(lenv));
+/* lvals, envs and their text are allocated here and counted against
+their interpreter. l is NULL on the reader threads of --jobs, whose
+counts would race with the interpreter's own */
+void* lalloc(lispy* l,size_t n){
+    if(l){
+        l->allocs++;
+        l->bytes+=n;
+        /* over the quota, evaluation stops at its next step */
+        if((l->room-=n)<0) l->fuel=-1;
+    }
+    return malloc(n);
+}
+/* growing what lalloc gave from old to n bytes counts the difference.
+shrinking gives nothing back, as freeing doesn't */
+void* lrealloc(lispy* l,void* p,size_t old,size_t n){
+    if(l&&n>old){
+        l->bytes+=n-old;
+        if((l->room-=n-old)<0) l->fuel=-1;
+    }
+    return realloc(p,n);
+}
+lenv* lenv_new(lispy* l){
+    lenv* e=lalloc(l,sizeof(lenv));
+    e->l=l;
     e->par=NULL;
+    e->top=0;
     e->count=0;
     e->syms=NULL;
     e->vals=NULL;
     return e;
 }
-lval* lval_num(long x){
-    lval* v=malloc(sizeof(lval));
+lval* lval_num(lispy* l,long x){
+    lval* v=lalloc(l,sizeof(lval));
     v->type=LVAL_NUM;
     v->num=x;
     return v;
 }
-lval* lval_err(char* fmt,...){
-    lval* v=malloc(sizeof(lval));
+lval* lval_err(lispy* l,char* fmt,...){
+    lval* v=lalloc(l,sizeof(lval));
     v->type=LVAL_ERR;
 
     va_list va;
     /* initialize va with the last named argument */
     va_start(va,fmt);
-    v->err=malloc(512);
+    v->err=lalloc(l,512);
     vsnprintf(v->err,511,fmt,va);
     v->err=realloc(v->err,strlen(v->err)+1);
     va_end(va);
     return v;
 }
-lval* lval_sym(char* s){
-    lval* v=malloc(sizeof(lval));
+lval* lval_sym(lispy* l,char* s){
+    lval* v=lalloc(l,sizeof(lval));
     v->type=LVAL_SYM;
-    v->sym=malloc(strlen(s)+1);
+    v->sym=lalloc(l,strlen(s)+1);
     strcpy(v->sym,s);
     return v;
 }
-lval* lval_sexpr(){
-    lval* v=malloc(sizeof(lval));
+lval* lval_sexpr(lispy* l){
+    lval* v=lalloc(l,sizeof(lval));
     v->type=LVAL_SEXPR;
     v->count=0;
     v->cell=NULL;
     return v;
 }
-lval* lval_qexpr(){
-    lval* v=malloc(sizeof(lval));
+lval* lval_qexpr(lispy* l){
+    lval* v=lalloc(l,sizeof(lval));
     v->type=LVAL_QEXPR;
     v->count=0;
     v->cell=NULL;
     return v;
 }
-lval* lval_fun(lbuiltin func){
-    lval* v=malloc(sizeof(lval));
+lval* lval_fun(lispy* l,lbuiltin func){
+    lval* v=lalloc(l,sizeof(lval));
     v->type=LVAL_FUN;
     v->builtin=func;
     return v;
 }
-lval* lval_lambda(lval* formals,lval* body){
-    lval* v=malloc(sizeof(lval));
+lval* lval_lambda(lispy* l,lval* formals,lval* body){
+    lval* v=lalloc(l,sizeof(lval));
     v->type=LVAL_FUN;
     v->builtin=NULL;
-    v->env=lenv_new();
+    v->env=lenv_new(l);
     v->formals=formals;
     v->body=body;
     return v;
 }
-lval* lval_str(char* s){
-    lval* v=malloc(sizeof(lval));
+lval* lval_str(lispy* l,char* s){
+    lval* v=lalloc(l,sizeof(lval));
     v->type=LVAL_STR;
-    v->str=malloc(strlen(s)+1);
+    v->str=lalloc(l,strlen(s)+1);
     strcpy(v->str,s);
     return v;
 }
+/* a string which keeps s, rather than a copy */
+lval* lval_str_take(lispy* l,char* s){
+    lval* v=lalloc(l,sizeof(lval));
+    v->type=LVAL_STR;
+    v->str=s;
+    return v;
+}
 
 /* destruct lval */
 void lval_del(lval* v){
@@ -225,127 +406,331 @@ void lenv_del(lenv* e){
 }
 
 /* read */
-lval* lval_read_str(mpc_ast_t* t) {
+lval* lval_read_str(lispy* l,mpc_ast_t* t) {
   /* Cut off the final quote character */
   t->contents[strlen(t->contents)-1] = '\0';
   /* Copy the string missing out the first quote character */
   char* unescaped = malloc(strlen(t->contents+1)+1);
   strcpy(unescaped, t->contents+1);
   unescaped = mpcf_unescape(unescaped);
-  lval* str = lval_str(unescaped);
+  lval* str = lval_str(l,unescaped);
   free(unescaped);
   return str;
 }
-lval* lval_read_num(mpc_ast_t* t){
+lval* lval_read_num(lispy* l,mpc_ast_t* t){
     errno=0;
     long x=strtol(t->contents,NULL,10);
-    return errno!=ERANGE ? lval_num(x) 
-    : lval_err("invalid number");
+    return errno!=ERANGE ? lval_num(l,x) 
+    : lval_err(l,"invalid number");
 }
-lval* lval_add(lval* v,lval* x){
+lval* lval_add(lispy* l,lval* v,lval* x){
     v->count++;
-    v->cell=realloc(v->cell,sizeof(lval*) * (v->count));
+    v->cell=lrealloc(l,v->cell,sizeof(lval*)*(v->count-1),sizeof(lval*)*(v->count));
     v->cell[v->count-1]=x;
     return v;
 }
-lval* lval_read(mpc_ast_t* t){
-    if(strstr(t->tag,"number")){
+/* what lval_read makes of a tag. arena ASTs number each distinct
+tag of a parse, so a tag's kind is worked out once and lval_read
+only compares ids after that. the kinds are kept per read, so
+reads may run on several threads at once */
+enum { LTAG_NUMBER=1, LTAG_SYMBOL=2, LTAG_STRING=4, LTAG_SEXPR=8,
+    LTAG_QEXPR=16, LTAG_SKIP=32, LTAG_KNOWN=64 };
+#define LTAG_MAX 64
+int ltag_kind(mpc_ast_t* t,int* kinds){
+    int id=t->tag_id;
+    if(id>=0&&id<LTAG_MAX&&kinds[id]) return kinds[id];
+    int k=LTAG_KNOWN;
+    if(strstr(t->tag,"number")) k|=LTAG_NUMBER;
+    if(strstr(t->tag,"symbol")) k|=LTAG_SYMBOL;
+    if(strstr(t->tag,"string")) k|=LTAG_STRING;
+    /* the root(>) is read as an sexpr */
+    if(strcmp(t->tag,">")==0||strstr(t->tag,"sexpr")) k|=LTAG_SEXPR;
+    if(strstr(t->tag,"qexpr")) k|=LTAG_QEXPR;
+    if(strcmp(t->tag,"regex")==0||strstr(t->tag,"comment")) k|=LTAG_SKIP;
+    if(id>=0&&id<LTAG_MAX) kinds[id]=k;
+    return k;
+}
+lval* lval_read(lispy* l,mpc_ast_t* t,int* kinds){
+    int k=ltag_kind(t,kinds);
+    if(k&LTAG_NUMBER){
         /* numbers need extra check(though seems it's better to
          only give the number to the func to check) */
-        return lval_read_num(t);
+        return lval_read_num(l,t);
     }
-    if(strstr(t->tag,"symbol")){
-        return lval_sym(t->contents);
+    if(k&LTAG_SYMBOL){
+        return lval_sym(l,t->contents);
     }
-    if(strstr(t->tag,"string")){
-        return lval_read_str(t);
+    if(k&LTAG_STRING){
+        return lval_read_str(l,t);
     }
     /* if root(>) or sexpr then create empty list */
     lval* x=NULL;
-    if(strcmp(t->tag,">")==0){
-        x=lval_sexpr();
-    }
-    if(strstr(t->tag,"sexpr")){
-        x=lval_sexpr();
-    }
-    if(strstr(t->tag,"qexpr")){
-        x=lval_qexpr();
+    if(k&LTAG_QEXPR){
+        x=lval_qexpr(l);
+    }else if(k&LTAG_SEXPR){
+        x=lval_sexpr(l);
     }
     /* fill the list with any valid expression contained within */
     for (int i = 0; i < t->children_num; i++)
     {
-        if(strcmp(t->children[i]->contents,"(")==0) continue;
-        if(strcmp(t->children[i]->contents,")")==0) continue;
-        if(strcmp(t->children[i]->contents,"{")==0) continue;
-        if(strcmp(t->children[i]->contents,"}")==0) continue;
-        if(strcmp(t->children[i]->tag,"regex")==0) continue;
-        if(strstr(t->children[i]->tag,"comment")) continue;
+        char* c=t->children[i]->contents;
+        if(c[0]&&c[1]=='\0'&&strchr("(){}",c[0])) continue;
+        if(ltag_kind(t->children[i],kinds)&LTAG_SKIP) continue;
         
-        x=lval_add(x,lval_read(t->children[i]));
+        x=lval_add(l,x,lval_read(l,t->children[i],kinds));
     }
     
     return x;
 }
+/* read a whole parse, whose tag ids are its own */
+lval* lval_read_ast(lispy* l,mpc_ast_t* t){
+    int kinds[LTAG_MAX]={0};
+    lval* x=lval_read(l,t,kinds);
+    mpc_ast_delete(t);
+    return x;
+}
+/* direct reader: tokenises source text and builds lvals
+straight away, accepting exactly what the Lispy grammar does.
+anything it rejects is handed to mpc, so errors are reported
+exactly as the grammar would report them */
+
+/* deeper lists are left to mpc, which has its own limit */
+#define LREAD_MAX_DEPTH 64
+
+int lread_space(char c){
+    return c==' '||c=='\f'||c=='\n'||c=='\r'||c=='\t'||c=='\v';
+}
+int lread_digit(char c){
+    return c>='0'&&c<='9';
+}
+int lread_symbol(char c){
+    return (c>='a'&&c<='z')||(c>='A'&&c<='Z')||lread_digit(c)
+        ||(c!='\0'&&strchr("_+-*/\\=<>!&",c));
+}
+/* skip whitespace and comments */
+void lread_blank(char** s){
+    while(1){
+        while(lread_space(**s)) (*s)++;
+        if(**s!=';') return;
+        while(**s&&**s!='\r'&&**s!='\n') (*s)++;
+    }
+}
+lval* lread_expr(lispy* l,char** s,int depth);
+/* read expressions into x up to the closing character */
+lval* lread_list(lispy* l,char** s,lval* x,char close,int depth){
+    lread_blank(s);
+    while(**s!=close){
+        lval* y=lread_expr(l,s,depth);
+        if(!y){
+            lval_del(x);
+            return NULL;
+        }
+        x=lval_add(l,x,y);
+        lread_blank(s);
+    }
+    if(close) (*s)++;
+    return x;
+}
+lval* lread_expr(lispy* l,char** s,int depth){
+    char* p=*s;
+    /* number, which wins over symbol as in the grammar */
+    if(lread_digit(p[0])||(p[0]=='-'&&lread_digit(p[1]))){
+        errno=0;
+        long x=strtol(p,s,10);
+        return errno!=ERANGE ? lval_num(l,x)
+        : lval_err(l,"invalid number");
+    }
+    if(lread_symbol(p[0])){
+        while(lread_symbol(**s)) (*s)++;
+        char c=**s;
+        **s='\0';
+        lval* sym=lval_sym(l,p);
+        **s=c;
+        return sym;
+    }
+    if(p[0]=='"'){
+        /* an escape is a backslash and anything but a newline */
+        char* q=p+1;
+        while(*q!='"'){
+            if(*q=='\0') return NULL;
+            if(*q=='\\'&&q[1]!='\n'&&q[1]!='\0') q++;
+            q++;
+        }
+        *s=q+1;
+        *q='\0';
+        char* unescaped=malloc(q-p);
+        strcpy(unescaped,p+1);
+        *q='"';
+        unescaped=mpcf_unescape(unescaped);
+        lval* str=lval_str(l,unescaped);
+        free(unescaped);
+        return str;
+    }
+    if(depth==LREAD_MAX_DEPTH) return NULL;
+    if(p[0]=='('){
+        (*s)++;
+        return lread_list(l,s,lval_sexpr(l),')',depth+1);
+    }
+    if(p[0]=='{'){
+        (*s)++;
+        return lread_list(l,s,lval_qexpr(l),'}',depth+1);
+    }
+    return NULL;
+}
+/* turn a finished mpc parse into forms or an error message */
+lval* lval_read_result(lispy* l,int ok,mpc_result_t* r,char** err){
+    if(!ok){
+        *err=mpc_err_string(r->error);
+        mpc_err_delete(r->error);
+        return NULL;
+    }
+    return lval_read_ast(l,r->output);
+}
+/* read all forms of src into an S-Expression, or
+return NULL and set err to the parse error */
+lval* lval_read_source(lispy* l,char* filename,char* src,char** err){
+    if(!l->read_with_mpc){
+        char* s=src;
+        lval* x=lread_list(l,&s,lval_sexpr(l),'\0',0);
+        if(x) return x;
+    }
+    /* the generated parser only pays off when it is likely to succeed */
+    mpc_result_t r;
+    int ok=l->read_with_mpc&&l->grammar.current
+        ?lispy_grammar_parse(filename,src,l->grammar.Lispy,&r,1)
+        :mpc_context_parse_arena(l->reader,filename,src,l->grammar.Lispy,&r);
+    return lval_read_result(l,ok,&r,err);
+}
 /* print */
-void lval_print_str(lval* v){
-    char* escaped=malloc(strlen(v->str)+1);
-    strcpy(escaped,v->str);
-    escaped=mpcf_escape(escaped);
-    printf("\"%s\"",escaped);
-    free(escaped);
-}
-void lval_expr_print(lval* v,char open, char close){
-    putchar(open);
+
+void lbuf_put(lbuf* b,const void* p,long n){
+    while(b->len+n>b->cap){
+        b->cap=b->cap ? b->cap*2 : 256;
+        b->data=realloc(b->data,b->cap);
+    }
+    memcpy(b->data+b->len,p,n);
+    b->len+=n;
+}
+void lbuf_putc(lbuf* b,char c){
+    if(b->len==b->cap){
+        b->cap=b->cap ? b->cap*2 : 256;
+        b->data=realloc(b->data,b->cap);
+    }
+    b->data[b->len++]=c;
+}
+void lbuf_puts(lbuf* b,char* s){
+    lbuf_put(b,s,strlen(s));
+}
+void lbuf_put_num(lbuf* b,long x){
+    char c[24];
+    int n=sizeof(c);
+    unsigned long u=x<0 ? -(unsigned long)x : (unsigned long)x;
+    do{
+        c[--n]='0'+u%10;
+        u/=10;
+    }while(u);
+    if(x<0) c[--n]='-';
+    lbuf_put(b,c+n,sizeof(c)-n);
+}
+
+/* text of a value, written into a buffer. strings are escaped as
+mpcf_escape does, as they are copied */
+void lval_write(lbuf* b,lval* v);
+
+void lval_write_str(lbuf* b,char* s){
+    lbuf_putc(b,'"');
+    while(*s){
+        char* run=s;
+        while(*s&&!strchr("\a\b\f\n\r\t\v\\\'\"",*s)) s++;
+        lbuf_put(b,run,s-run);
+        if(!*s) break;
+        lbuf_putc(b,'\\');
+        switch(*s){
+            case '\a': lbuf_putc(b,'a'); break;
+            case '\b': lbuf_putc(b,'b'); break;
+            case '\f': lbuf_putc(b,'f'); break;
+            case '\n': lbuf_putc(b,'n'); break;
+            case '\r': lbuf_putc(b,'r'); break;
+            case '\t': lbuf_putc(b,'t'); break;
+            case '\v': lbuf_putc(b,'v'); break;
+            default: lbuf_putc(b,*s); break;
+        }
+        s++;
+    }
+    lbuf_putc(b,'"');
+}
+void lval_write_expr(lbuf* b,lval* v,char open, char close){
+    lbuf_putc(b,open);
     for (int i = 0; i < v->count; i++)
     {
-        lval_print(v->cell[i]);
+        lval_write(b,v->cell[i]);
         /* avoid print trailing space if it's the last one */
-        if(i!=(v->count-1)) putchar(' ');
+        if(i!=(v->count-1)) lbuf_putc(b,' ');
     }
-    
-    putchar(close);
+    lbuf_putc(b,close);
 }
-void lval_print(lval* v){
+void lval_write(lbuf* b,lval* v){
     switch(v->type){
         case LVAL_NUM: 
-            printf("%li",v->num);
+            lbuf_put_num(b,v->num);
             break;
         case LVAL_FUN:
             if(v->builtin){
-                printf("<builtin>");
+                lbuf_puts(b,"<builtin>");
             }else{
-                printf("(\\");
-                lval_print(v->formals);
-                putchar(' ');
-                lval_print(v->body);
-                putchar(')');
+                lbuf_puts(b,"(\\");
+                lval_write(b,v->formals);
+                lbuf_putc(b,' ');
+                lval_write(b,v->body);
+                lbuf_putc(b,')');
             }
             break;
         case LVAL_ERR: 
-            printf("Error:%s",v->err);
+            lbuf_puts(b,"Error:");
+            lbuf_puts(b,v->err);
             break;
         case LVAL_SYM:
-            printf("%s",v->sym);
+            lbuf_puts(b,v->sym);
             break;
         case LVAL_STR:
-            lval_print_str(v);
+            lval_write_str(b,v->str);
             break;
         case LVAL_SEXPR:
-            lval_expr_print(v,'(',')');
+            lval_write_expr(b,v,'(',')');
             break;
         case LVAL_QEXPR:
-            lval_expr_print(v,'{','}');
+            lval_write_expr(b,v,'{','}');
             break;
     }
 }
-void lval_println(lval* v){
-    lval_print(v);
-    putchar('\n');
+
+/* standard output is written from an interpreter's out buffer in
+large pieces. it is flushed before reading input and before anything
+else prints */
+#define LOUT_FLUSH 65536
+
+void lout_flush(lispy* l){
+    fwrite(l->out.data,1,l->out.len,stdout);
+    fflush(stdout);
+    l->out.len=0;
+}
+/* flush once enough is held */
+void lout_done(lispy* l){
+    if(l->out.len>=LOUT_FLUSH&&!l->out_hold) lout_flush(l);
+}
+void lval_print(lispy* l,lval* v){
+    lval_write(&l->out,v);
+    lout_done(l);
+}
+void lval_println(lispy* l,lval* v){
+    lval_write(&l->out,v);
+    lbuf_putc(&l->out,'\n');
+    lout_done(l);
 }
 
 /* copy a lval */
-lval* lval_copy(lval* v){
-    lval* x=malloc(sizeof(lval));
+lval* lval_copy(lispy* l,lval* v){
+    lval* x=lalloc(l,sizeof(lval));
     x->type=v->type;
 
     switch(v->type){
@@ -355,33 +740,33 @@ lval* lval_copy(lval* v){
             }else{
                 x->builtin=NULL;
                 x->env=lenv_copy(v->env);
-                x->formals=lval_copy(v->formals);
-                x->body=lval_copy(v->body);
+                x->formals=lval_copy(l,v->formals);
+                x->body=lval_copy(l,v->body);
             }
             break;
         case LVAL_NUM:
             x->num=v->num;
             break;
         case LVAL_ERR:
-            x->err=malloc(strlen(v->err)+1);
+            x->err=lalloc(l,strlen(v->err)+1);
             strcpy(x->err,v->err);
             break;
         case LVAL_SYM:
-            x->sym=malloc(strlen(v->sym)+1);
+            x->sym=lalloc(l,strlen(v->sym)+1);
             strcpy(x->sym,v->sym);
             break;
         case LVAL_STR:
-            x->str=malloc(strlen(v->str)+1);
+            x->str=lalloc(l,strlen(v->str)+1);
             strcpy(x->str,v->str);
             break;
         case LVAL_SEXPR:
         case LVAL_QEXPR:
         /* copy lists by copying each sub-expr */
             x->count=v->count;
-            x->cell=malloc(sizeof(lval*)*(x->count));
+            x->cell=lalloc(l,sizeof(lval*)*(x->count));
             for (int i = 0; i < x->count; i++)
             {
-                x->cell[i]=lval_copy(v->cell[i]);
+                x->cell[i]=lval_copy(l,v->cell[i]);
             }
             break;
     }
@@ -411,13 +796,13 @@ lval* lenv_get(lenv* e,lval* k){
     for (int i = 0; i < e->count; i++)
     {
         if(strcmp(e->syms[i],k->sym)==0){
-            return lval_copy(e->vals[i]);
+            return lval_copy(e->l,e->vals[i]);
         }
     }
     if(e->par){
         return lenv_get(e->par,k);
     }else{
-        return lval_err("Unbound symbol '%s'",k->sym);
+        return lval_err(e->l,"Unbound symbol '%s'",k->sym);
     }
 }
 void lenv_put(lenv* e,lval* k,lval* v){
@@ -425,34 +810,36 @@ void lenv_put(lenv* e,lval* k,lval* v){
     {
         if(strcmp(e->syms[i],k->sym)==0){
             lval_del(e->vals[i]);
-            e->vals[i]=lval_copy(v);
+            e->vals[i]=lval_copy(e->l,v);
             return;
         }
     }
     /* if nothing found in env */
     e->count++;
-    e->vals=realloc(e->vals,sizeof(lval*)*(e->count));
-    e->syms=realloc(e->syms,sizeof(char*)*(e->count));
-    e->vals[e->count-1]=lval_copy(v);
-    e->syms[e->count-1]=malloc(strlen(k->sym)+1);
+    e->vals=lrealloc(e->l,e->vals,sizeof(lval*)*(e->count-1),sizeof(lval*)*(e->count));
+    e->syms=lrealloc(e->l,e->syms,sizeof(char*)*(e->count-1),sizeof(char*)*(e->count));
+    e->vals[e->count-1]=lval_copy(e->l,v);
+    e->syms[e->count-1]=lalloc(e->l,strlen(k->sym)+1);
     strcpy(e->syms[e->count-1],k->sym);
 }
 /* define env globally */
 void lenv_def(lenv* e,lval* k,lval* v){
-    while(e->par) e=e->par;
+    while(e->par&&!e->top) e=e->par;
     lenv_put(e,k,v);
 }
 /* copy a lenv */
 lenv* lenv_copy(lenv* e){
-    lenv* n=malloc(sizeof(lenv));
+    lenv* n=lalloc(e->l,sizeof(lenv));
+    n->l=e->l;
     n->par=e->par;
+    n->top=0;
     n->count=e->count;
-    n->syms=malloc(sizeof(char*)*(n->count));
-    n->vals=malloc(sizeof(lval*)*(n->count));
+    n->syms=lalloc(e->l,sizeof(char*)*(n->count));
+    n->vals=lalloc(e->l,sizeof(lval*)*(n->count));
     for(int i=0;i<e->count;i++){
-        n->syms[i]=malloc(strlen(e->syms[i])+1);
+        n->syms[i]=lalloc(e->l,strlen(e->syms[i])+1);
         strcpy(n->syms[i],e->syms[i]);
-        n->vals[i]=lval_copy(e->vals[i]);
+        n->vals[i]=lval_copy(e->l,e->vals[i]);
     }
     return n;
 }
@@ -478,7 +865,7 @@ lval* lval_eval_sexpr(lenv* e,lval* v){
     /* ensure the first element is a function */
     lval* f=lval_pop(v,0);
     if(f->type!=LVAL_FUN){
-        lval* err=lval_err(
+        lval* err=lval_err(e->l,
             "S-Expression starts with incorrect type. "
             "Got %s, Expected %s.",ltype_name(f->type),
             ltype_name(LVAL_FUN));
@@ -491,19 +878,88 @@ lval* lval_eval_sexpr(lenv* e,lval* v){
     lval_del(f);
     return result;
 }
+/* seconds on a clock that only goes forward */
+double lclock(void){
+#ifndef _WIN32
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC,&t);
+    return t.tv_sec+t.tv_nsec/1e9;
+#else
+    return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
+/* steps are handed out LFUEL_SLICE at a time, so a step only counts
+down, and between slices the other limits, the deadline and the
+interrupt flag are looked at. returns 0, with why in stop, once the
+evaluation has to end */
+#define LFUEL_SLICE 1024
+int lfuel(lispy* l){
+    if(!l->stop){
+        if(l->room<0) l->stop=LSTOP_BYTES;
+        else if(l->interrupt) l->stop=LSTOP_INTERRUPT;
+        else if(l->steps<=0) l->stop=LSTOP_STEPS;
+        else if(l->deadline&&lclock()>l->deadline) l->stop=LSTOP_TIME;
+    }
+    if(l->stop){
+        l->fuel=-1;
+        return 0;
+    }
+    long n=l->steps<LFUEL_SLICE ? l->steps : LFUEL_SLICE;
+    l->steps-=n;
+    /* this step is the first of the slice */
+    l->fuel=n-1;
+    return 1;
+}
+/* what evaluating gives once it has to end, which is every step left
+of the top-level evaluation, so it unwinds with the error */
+lval* lval_spent(lispy* l,lval* v){
+    lval_del(v);
+    switch(l->stop){
+        case LSTOP_BYTES:
+            return lval_err(l,"Evaluation allocated more than %ld bytes!",
+            l->max_bytes);
+        case LSTOP_STEPS:
+            return lval_err(l,"Evaluation took more than %ld steps!",
+            l->max_steps);
+        case LSTOP_TIME: return lval_err(l,"Evaluation timed out!");
+        default: return lval_err(l,"Evaluation interrupted!");
+    }
+}
+/* the limits start afresh for each top-level evaluation, and carry on
+through those inside it, like a load */
+void llimit_begin(lispy* l){
+    if(l->depth++) return;
+    l->steps=l->max_steps ? l->max_steps : LONG_MAX;
+    l->room=l->max_bytes ? l->max_bytes : LONG_MAX;
+    l->deadline=l->max_ms ? lclock()+l->max_ms/1000.0 : 0;
+    l->interrupt=0;
+    l->stop=0;
+    l->fuel=0;
+}
+void llimit_end(lispy* l){
+    if(--l->depth) return;
+    l->steps=l->room=LONG_MAX;
+    l->deadline=0;
+    l->stop=0;
+    l->fuel=0;
+}
 lval* lval_eval(lenv* e,lval* v){
+    e->l->evals++;
     if(v->type==LVAL_SYM){
         lval* x=lenv_get(e,v);
         lval_del(v);
         return x;
     }
     if(v->type==LVAL_SEXPR){
+        /* each S-Expression evaluated is a step */
+        if(--e->l->fuel<0&&!lfuel(e->l)) return lval_spent(e->l,v);
         return lval_eval_sexpr(e,v);
     }
 
     return v;
 }
 lval* lval_call(lenv* e,lval* f,lval* a){
+    e->l->calls++;
     if(f->builtin) return f->builtin(e,a);
 
     int given=a->count;
@@ -511,7 +967,7 @@ lval* lval_call(lenv* e,lval* f,lval* a){
     while(a->count){
         if(f->formals->count==0){
             lval_del(a);
-            return lval_err("Function passed too many"
+            return lval_err(e->l,"Function passed too many"
             " arguments. Got %d,Expected %d.",given,total);
         }
         lval* sym=lval_pop(f->formals,0);
@@ -519,7 +975,7 @@ lval* lval_call(lenv* e,lval* f,lval* a){
             /* ensure & is followed by another symbol */
             if(f->formals->count!=1){
                 lval_del(a);
-                return lval_err("Function format invalid. "
+                return lval_err(e->l,"Function format invalid. "
                 "Symbol '&' not followed by single symbol.");
             }
             /* Next formal should be bound to remaining arguments */
@@ -539,12 +995,12 @@ lval* lval_call(lenv* e,lval* f,lval* a){
 
     if(f->formals->count>0 && strcmp(f->formals->cell[0]->sym,"&")==0){
         if(f->formals->count!=2){
-            return lval_err("Function format invalid. "
+            return lval_err(e->l,"Function format invalid. "
             "Symbol '&' not followed by single symbol.");
         }
         lval_del(lval_pop(f->formals,0));
         lval* sym=lval_pop(f->formals,0);
-        lval* val=lval_qexpr();
+        lval* val=lval_qexpr(e->l);
         lenv_put(f->env,sym,val);
         lval_del(sym);
         lval_del(val);
@@ -552,17 +1008,17 @@ lval* lval_call(lenv* e,lval* f,lval* a){
  ;
     if(f->formals->count==0){
         f->env->par=e;
-        return builtin_eval(f->env,lval_add(lval_sexpr(),
-        lval_copy(f->body)));
+        return builtin_eval(f->env,lval_add(e->l,lval_sexpr(e->l),
+        lval_copy(e->l,f->body)));
     }else{
-        return lval_copy(f);
+        return lval_copy(e->l,f);
     }
 
     lval_del(a);
 
     f->env->par=e;
     return builtin_eval(f->env,
-    lval_add(lval_sexpr(),lval_copy(f->body)));
+    lval_add(e->l,lval_sexpr(e->l),lval_copy(e->l,f->body)));
 }
 
 /* builtin functions */
@@ -585,7 +1041,7 @@ lval* builtin_op(lenv* e,lval* a,char* op){
             if(y->num==0){
                 lval_del(x);
                 lval_del(y);
-                x=lval_err("Division by zero!");
+                x=lval_err(e->l,"Division by zero!");
                 break;
             }
             x->num /= y->num;
@@ -643,7 +1099,7 @@ lval* builtin_eval(lenv* e,lval* a){
 }
 lval* lval_join(lenv* e,lval* x,lval* y){
     while(y->count){
-        x=lval_add(x,lval_pop(y,0));
+        x=lval_add(e->l,x,lval_pop(y,0));
     }
     lval_del(y);
     return x;
@@ -670,7 +1126,7 @@ lval* builtin(lenv* e,lval* a, char* func){
     if(strstr("+-*/",func)) return builtin_op(e,a,func);
 
     lval_del(a);
-    return lval_err("Unknown Function!");
+    return lval_err(e->l,"Unknown Function!");
 }
 lval* builtin_lambda(lenv* e,lval* a){
     LASSERT_NUM("\\",a,2);
@@ -687,7 +1143,7 @@ lval* builtin_lambda(lenv* e,lval* a){
     lval* formals=lval_pop(a,0);
     lval* body=lval_pop(a,0);
     lval_del(a);
-    return lval_lambda(formals,body);
+    return lval_lambda(e->l,formals,body);
 }
 
 /* condition */
@@ -710,7 +1166,7 @@ lval* builtin_ord(lenv* e,lval* a,char* op){
         r=(a->cell[0]->num <= a->cell[1]->num);
     }
     lval_del(a);
-    return lval_num(r);
+    return lval_num(e->l,r);
 }
 lval* builtin_gt(lenv* e,lval* a){
     return builtin_ord(e,a,">");
@@ -756,7 +1212,7 @@ lval* builtin_cmp(lenv* e,lval* a,char* op){
     if(strcmp(op,"!=")==0) r=!lval_eq(a->cell[0],a->cell[1]);
 
     lval_del(a);
-    return lval_num(r);
+    return lval_num(e->l,r);
 }
 lval* builtin_eq(lenv* e,lval* a){
     return builtin_cmp(e,a,"==");
@@ -810,7 +1266,7 @@ lval* builtin_var(lenv* e,lval* a,char* func){
     }
     
     lval_del(a);
-    return lval_sexpr();
+    return lval_sexpr(e->l);
 }
 lval* builtin_put(lenv* e,lval* a){
     return builtin_var(e,a,"=");
@@ -819,41 +1275,860 @@ lval* builtin_def(lenv* e,lval* a){
     return builtin_var(e,a,"def");
 }
 
+/* binary */
+
+/* values in binary: a type byte, then a zigzag varint for numbers,
+a varint length and the bytes for errors, symbols and strings, and
+a varint count and the cells for expressions. a function is 1 and
+a builtin's name, or 0 and a lambda's environment, formals and body.
+environments are a varint count and each symbol and value */
+void lbuf_put_uint(lbuf* b,unsigned long x){
+    unsigned char c[10];
+    int n=0;
+    while(x>=0x80){
+        c[n++]=(unsigned char)(x|0x80);
+        x>>=7;
+    }
+    c[n++]=(unsigned char)x;
+    lbuf_put(b,c,n);
+}
+void lbuf_put_text(lbuf* b,char* s){
+    long n=strlen(s);
+    lbuf_put_uint(b,n);
+    lbuf_put(b,s,n);
+}
+/* returns 0 if the varint runs past end */
+int lbuf_get_uint(char** p,char* end,unsigned long* x){
+    *x=0;
+    for (int shift = 0; *p < end && shift < 64; shift += 7){
+        unsigned char c=*(*p)++;
+        *x|=(unsigned long)(c&0x7f)<<shift;
+        if(!(c&0x80)) return 1;
+    }
+    return 0;
+}
+
+void lenv_write_bin(lbuf* b,lenv* e);
+lenv* lenv_read_bin_at(lispy* l,char** p,char* end,int depth);
+
+/* values nested deeper than the grammar reads are not read back, so
+bad data can't run the decoder off the stack */
+#define LBIN_MAX_DEPTH 1000
+
+void lval_write_bin(lbuf* b,lval* v){
+    unsigned char t=v->type;
+    lbuf_put(b,&t,1);
+    switch(v->type){
+        case LVAL_NUM:
+            /* small negative numbers stay short */
+            lbuf_put_uint(b,v->num<0 ? ~((unsigned long)v->num<<1)
+                : (unsigned long)v->num<<1);
+            break;
+        case LVAL_ERR: lbuf_put_text(b,v->err); break;
+        case LVAL_SYM: lbuf_put_text(b,v->sym); break;
+        case LVAL_STR: lbuf_put_text(b,v->str); break;
+        case LVAL_FUN:
+            if(v->builtin){
+                lbuf_put_uint(b,1);
+                lbuf_put_text(b,lbuiltin_name(v->builtin));
+            }else{
+                lbuf_put_uint(b,0);
+                lenv_write_bin(b,v->env);
+                lval_write_bin(b,v->formals);
+                lval_write_bin(b,v->body);
+            }
+            break;
+        case LVAL_SEXPR:
+        case LVAL_QEXPR:
+            lbuf_put_uint(b,v->count);
+            for (int i = 0; i < v->count; i++){
+                lval_write_bin(b,v->cell[i]);
+            }
+            break;
+    }
+}
+/* an error, symbol or string of n bytes */
+lval* lval_read_bin_chars(lispy* l,char** p,char* end,int t,unsigned long n){
+    if(n>(unsigned long)(end-*p)) return NULL;
+    char* s=lalloc(l,n+1);
+    memcpy(s,*p,n);
+    s[n]='\0';
+    *p+=n;
+    lval* v=lalloc(l,sizeof(lval));
+    v->type=t;
+    if(t==LVAL_ERR) v->err=s;
+    if(t==LVAL_SYM) v->sym=s;
+    if(t==LVAL_STR) v->str=s;
+    return v;
+}
+/* text written by lbuf_put_text */
+lval* lval_read_bin_text(lispy* l,char** p,char* end,int t){
+    unsigned long n;
+    if(!lbuf_get_uint(p,end,&n)) return NULL;
+    return lval_read_bin_chars(l,p,end,t,n);
+}
+/* read a value written by lval_write_bin, depth lists and functions
+down, or NULL if the bytes up to end do not hold one */
+lval* lval_read_bin_at(lispy* l,char** p,char* end,int depth){
+    unsigned long n;
+    if(*p>=end||depth>LBIN_MAX_DEPTH) return NULL;
+    int t=(unsigned char)*(*p)++;
+    if(!lbuf_get_uint(p,end,&n)) return NULL;
+    lval* v;
+    switch(t){
+        case LVAL_NUM:
+            return lval_num(l,(long)(n>>1)^-(long)(n&1));
+        case LVAL_FUN:
+            if(n>1) return NULL;
+            if(n==1){
+                lval* name=lval_read_bin_text(l,p,end,LVAL_SYM);
+                if(!name) return NULL;
+                lbuiltin func=lbuiltin_find(name->sym);
+                lval_del(name);
+                return func ? lval_fun(l,func) : NULL;
+            }else{
+                lenv* env=lenv_read_bin_at(l,p,end,depth+1);
+                if(!env) return NULL;
+                lval* formals=lval_read_bin_at(l,p,end,depth+1);
+                lval* body=formals ? lval_read_bin_at(l,p,end,depth+1) : NULL;
+                /* as \ checks them, since calls rely on it */
+                int ok=body&&formals->type==LVAL_QEXPR&&body->type==LVAL_QEXPR;
+                for (int i = 0; ok && i < formals->count; i++){
+                    ok=formals->cell[i]->type==LVAL_SYM;
+                }
+                if(!ok){
+                    lenv_del(env);
+                    if(formals) lval_del(formals);
+                    if(body) lval_del(body);
+                    return NULL;
+                }
+                v=lval_lambda(l,formals,body);
+                lenv_del(v->env);
+                v->env=env;
+                return v;
+            }
+        case LVAL_ERR:
+        case LVAL_SYM:
+        case LVAL_STR:
+            return lval_read_bin_chars(l,p,end,t,n);
+        case LVAL_SEXPR:
+        case LVAL_QEXPR:
+            /* every cell takes two bytes at least */
+            if(n>(unsigned long)(end-*p)/2) return NULL;
+            v=t==LVAL_SEXPR ? lval_sexpr(l) : lval_qexpr(l);
+            v->cell=lalloc(l,sizeof(lval*)*n);
+            for (; v->count < (int)n; v->count++){
+                v->cell[v->count]=lval_read_bin_at(l,p,end,depth+1);
+                if(!v->cell[v->count]){
+                    lval_del(v);
+                    return NULL;
+                }
+            }
+            return v;
+    }
+    return NULL;
+}
+lval* lval_read_bin(lispy* l,char** p,char* end){
+    return lval_read_bin_at(l,p,end,0);
+}
+
+void lenv_write_bin(lbuf* b,lenv* e){
+    lbuf_put_uint(b,e->count);
+    for (int i = 0; i < e->count; i++){
+        lbuf_put_text(b,e->syms[i]);
+        lval_write_bin(b,e->vals[i]);
+    }
+}
+/* the environment read has no parent, which is only set on a call */
+lenv* lenv_read_bin_at(lispy* l,char** p,char* end,int depth){
+    unsigned long n;
+    if(!lbuf_get_uint(p,end,&n)) return NULL;
+    /* every entry takes three bytes at least */
+    if(n>(unsigned long)(end-*p)/3) return NULL;
+    lenv* e=lenv_new(l);
+    e->syms=lalloc(l,sizeof(char*)*n);
+    e->vals=lalloc(l,sizeof(lval*)*n);
+    for (; e->count < (int)n; e->count++){
+        lval* k=lval_read_bin_text(l,p,end,LVAL_SYM);
+        lval* v=k ? lval_read_bin_at(l,p,end,depth) : NULL;
+        if(!v){
+            if(k) lval_del(k);
+            lenv_del(e);
+            return NULL;
+        }
+        e->syms[e->count]=k->sym;
+        e->vals[e->count]=v;
+        free(k);
+    }
+    return e;
+}
+lenv* lenv_read_bin(lispy* l,char** p,char* end){
+    return lenv_read_bin_at(l,p,end,0);
+}
+
 /* load */
-lval* builtin_load(lenv* e,lval* a) {
-  LASSERT_NUM("load", a, 1);
-  LASSERT_TYPE("load", a, 0, LVAL_STR);
 
-  /* Parse File given by string name */
-  mpc_result_t r;
-  if (mpc_parse_contents(a->cell[0]->str, Lispy, &r)) {
+/* files are loaded as a stream: input is read in chunks and cut
+at top level boundaries, and each form is read, evaluated and
+freed before the next. memory is bounded by the largest form
+rather than by the file, and pipes work as well as files */
+#define LSTREAM_CHUNK 65536
+#define LHASH_START 2166136261UL
+
+/* FNV-1a, as for the grammar, carried on from h */
+unsigned long lcache_hash(unsigned long h,char* p,long n){
+    for (long i = 0; i < n; i++){
+        h=((h^(unsigned char)p[i])*16777619UL)&0xffffffffUL;
+    }
+    return h;
+}
+
+typedef struct {
+    FILE* f;
+    char* buf;
+    long len,cap;
+    /* bytes scanned, and end of the complete forms among them */
+    long scan,cut;
+    int depth,str,comment,eof;
+    /* where buf starts in the file */
+    long row,col;
+    /* of the bytes read so far, for the cache */
+    unsigned long hash;
+} lstream;
+
+/* find the last top level boundary in the bytes read so far */
+void lstream_scan(lstream* s){
+    while(s->scan<s->len){
+        char c=s->buf[s->scan];
+        if(s->str){
+            if(c=='\\'){
+                /* wait to see if this is an escape */
+                if(s->scan+1==s->len&&!s->eof) return;
+                if(s->scan+1<s->len&&s->buf[s->scan+1]!='\n') s->scan++;
+            }else if(c=='"'){
+                s->str=0;
+            }
+        }else if(s->comment){
+            if(c=='\r'||c=='\n'){
+                s->comment=0;
+                continue;
+            }
+        }else if(c=='"'){
+            s->str=1;
+        }else if(c==';'){
+            s->comment=1;
+        }else if(c=='('||c=='{'){
+            s->depth++;
+        }else if(c==')'||c=='}'){
+            if(s->depth>0) s->depth--;
+            if(s->depth==0) s->cut=s->scan+1;
+        }else if(s->depth==0&&lread_space(c)){
+            s->cut=s->scan;
+        }
+        s->scan++;
+    }
+}
+void lstream_fill(lstream* s){
+    while(s->len+LSTREAM_CHUNK+1>s->cap){
+        s->cap=s->cap ? s->cap*2 : LSTREAM_CHUNK+1;
+        s->buf=realloc(s->buf,s->cap);
+    }
+    long n=fread(s->buf+s->len,1,LSTREAM_CHUNK,s->f);
+    /* like a string, the source ends at any zero byte */
+    char* z=memchr(s->buf+s->len,'\0',n);
+    if(z){
+        n=z-(s->buf+s->len);
+        s->eof=1;
+    }
+    if(n<LSTREAM_CHUNK) s->eof=1;
+    s->hash=lcache_hash(s->hash,s->buf+s->len,n);
+    s->len+=n;
+}
+/* forget the first n bytes */
+void lstream_drop(lstream* s,long n){
+    for (long i = 0; i < n; i++)
+    {
+        if(s->buf[i]=='\n'){
+            s->row++;
+            s->col=0;
+        }else{
+            s->col++;
+        }
+    }
+    memmove(s->buf,s->buf+n,s->len-n);
+    s->len-=n;
+    s->scan-=n;
+    s->cut=0;
+}
+void lval_load_eval(lenv* e,lval* x){
+    llimit_begin(e->l);
+    x=lval_eval(e,x);
+    llimit_end(e->l);
+    /* If Evaluation leads to error print it */
+    if(x->type==LVAL_ERR) lval_println(e->l,x);
+    lval_del(x);
+}
+
+/* reading a chunk never looks at the environment, so with --jobs
+chunks are read on a pool of threads while the main thread
+evaluates those before them, in file order. the chunks are the
+same as when loading on one thread, so the result is too */
+typedef struct lload_job {
+    /* whose grammar reads it */
+    lispy* l;
+    char* src;
+    char* filename;
+    /* where src starts in the file */
+    long row,col;
+    /* forms read and not yet evaluated, how many were read
+    in all, and the parse error after them */
+    lval** forms;
+    int count,slots,read;
+    char* err;
+    /* set when read on the main thread, which evaluates
+    each form as it is read, as loading always did */
+    lenv* env;
+    /* the forms in binary, when they are being cached */
+    lbuf* bin;
+    int done;
+    /* next in the pool's queue, and in its file */
+    struct lload_job* next;
+    struct lload_job* after;
+} lload_job;
+
+struct lload_pool {
+    pthread_t* threads;
+    int num,stop;
+    pthread_mutex_t lock;
+    pthread_cond_t more,done;
+    lload_job* head;
+    lload_job* tail;
+};
+
+void lload_add(lload_job* j,lval* x){
+    j->read++;
+    if(j->bin) lval_write_bin(j->bin,x);
+    if(j->env){
+        lval_load_eval(j->env,x);
+        return;
+    }
+    /* a chunk holds thousands of forms, so grow by doubling */
+    if(j->count==j->slots){
+        j->slots=j->slots ? j->slots*2 : 64;
+        j->forms=realloc(j->forms,sizeof(lval*)*j->slots);
+    }
+    j->forms[j->count++]=x;
+}
+/* add the forms mpc read after those the direct reader already did */
+void lload_add_ast(lload_job* j,lispy* l,mpc_ast_t* t){
+    lval* all=lval_read_ast(l,t);
+    for (int i = 0; i < all->count; i++){
+        if(i<j->read){
+            lval_del(all->cell[i]);
+        }else{
+            lload_add(j,all->cell[i]);
+        }
+    }
+    all->count=0;
+    lval_del(all);
+}
+/* after mpc found an error in a chunk, read the forms before it, from
+p on. the direct reader reads what it can, and a form nested too deep
+for it is cut out at its closing bracket and read by mpc on its own */
+void lload_read_before(lload_job* j,lispy* l,mpc_context_t* c,char* p){
+    while(1){
+        lread_blank(&p);
+        if(*p=='\0') return;
+        char* q=p;
+        lval* x=lread_expr(l,&q,0);
+        if(x){
+            p=q;
+            lload_add(j,x);
+            continue;
+        }
+        lstream s={0};
+        s.buf=p;
+        s.eof=1;
+        long n=strlen(p);
+        while(s.cut==0&&s.len<n){
+            s.len++;
+            lstream_scan(&s);
+        }
+        if(s.cut==0) return;
+        char cut=p[s.cut];
+        p[s.cut]='\0';
+        mpc_result_t r;
+        int ok=mpc_context_parse_arena(c,j->filename,p,j->l->grammar.Lispy,&r);
+        if(ok){
+            lval* all=lval_read_ast(l,r.output);
+            for (int i = 0; i < all->count; i++){
+                lload_add(j,all->cell[i]);
+            }
+            all->count=0;
+            lval_del(all);
+        }else{
+            mpc_err_delete(r.error);
+        }
+        p[s.cut]=cut;
+        if(!ok) return;
+        p+=s.cut;
+    }
+}
+/* read a chunk with the direct reader, handing mpc what it could
+not read. mpc reads the whole chunk, as the token before an error
+can add to what the error expects. with either reader the forms
+before an error are kept, so they are evaluated as they would be
+one at a time */
+void lload_read(lload_job* j,mpc_context_t* c){
+    /* what the pool's threads read is not counted */
+    lispy* l=j->env ? j->l : NULL;
+    char* p=j->src;
+    if(!j->l->read_with_mpc){
+        while(1){
+            lread_blank(&p);
+            if(*p=='\0') return;
+            char* q=p;
+            lval* x=lread_expr(l,&q,0);
+            if(!x) break;
+            p=q;
+            lload_add(j,x);
+        }
+    }
+    /* with --mpc the chunk goes to the generated parser, as in
+    lval_read_source */
+    mpc_result_t r;
+    int ok=j->l->read_with_mpc&&j->l->grammar.current
+        ?lispy_grammar_parse(j->filename,j->src,j->l->grammar.Lispy,&r,1)
+        :mpc_context_parse_arena(c,j->filename,j->src,j->l->grammar.Lispy,&r);
+    if(ok){
+        lval* all=lval_read_ast(l,r.output);
+        for (int i = 0; i < all->count; i++){
+            if(i<j->read){
+                lval_del(all->cell[i]);
+            }else{
+                lload_add(j,all->cell[i]);
+            }
+        }
+        all->count=0;
+        lval_del(all);
+        return;
+    }
+    /* position the error within the file */
+    if(r.error->state.row==0) r.error->state.col+=j->col;
+    r.error->state.row+=j->row;
+    j->err=mpc_err_string(r.error);
+    mpc_err_delete(r.error);
+    lload_read_before(j,l,c,p);
+}
+void* lload_work(void* arg){
+    lload_pool* p=arg;
+    mpc_context_t* c=mpc_context_new();
+    pthread_mutex_lock(&p->lock);
+    while(1){
+        while(!p->head&&!p->stop) pthread_cond_wait(&p->more,&p->lock);
+        if(!p->head) break;
+        lload_job* j=p->head;
+        p->head=j->next;
+        if(!p->head) p->tail=NULL;
+        pthread_mutex_unlock(&p->lock);
+        lload_read(j,c);
+        pthread_mutex_lock(&p->lock);
+        j->done=1;
+        pthread_cond_broadcast(&p->done);
+    }
+    pthread_mutex_unlock(&p->lock);
+    mpc_context_delete(c);
+    return NULL;
+}
+lload_pool* lload_pool_new(int num){
+    lload_pool* p=calloc(1,sizeof(lload_pool));
+    pthread_mutex_init(&p->lock,NULL);
+    pthread_cond_init(&p->more,NULL);
+    pthread_cond_init(&p->done,NULL);
+    p->threads=malloc(sizeof(pthread_t)*num);
+    for (int i = 0; i < num; i++){
+        if(pthread_create(&p->threads[i],NULL,lload_work,p)!=0) break;
+        p->num++;
+    }
+    return p;
+}
+void lload_pool_del(lload_pool* p){
+    pthread_mutex_lock(&p->lock);
+    p->stop=1;
+    pthread_cond_broadcast(&p->more);
+    pthread_mutex_unlock(&p->lock);
+    for (int i = 0; i < p->num; i++) pthread_join(p->threads[i],NULL);
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->more);
+    pthread_cond_destroy(&p->done);
+    free(p->threads);
+    free(p);
+}
+/* read the complete forms held, up to the cut, or have them read */
+lload_job* lload_submit(lenv* e,lstream* s,char* filename,int bin){
+    lload_job* j=calloc(1,sizeof(lload_job));
+    if(bin) j->bin=calloc(1,sizeof(lbuf));
+    lispy* l=e->l;
+    j->l=l;
+    j->src=malloc(s->cut+1);
+    memcpy(j->src,s->buf,s->cut);
+    j->src[s->cut]='\0';
+    j->filename=filename;
+    j->row=s->row;
+    j->col=s->col;
+    lload_pool* p=l->loader;
+    if(!p||p->num==0){
+        j->env=e;
+        lload_read(j,l->reader);
+        j->done=1;
+        return j;
+    }
+    pthread_mutex_lock(&p->lock);
+    if(p->tail) p->tail->next=j;
+    else p->head=j;
+    p->tail=j;
+    pthread_cond_signal(&p->more);
+    pthread_mutex_unlock(&p->lock);
+    return j;
+}
+void lload_wait(lload_job* j){
+    lload_pool* p=j->l->loader;
+    if(!p||p->num==0) return;
+    pthread_mutex_lock(&p->lock);
+    while(!j->done) pthread_cond_wait(&p->done,&p->lock);
+    pthread_mutex_unlock(&p->lock);
+}
+/* free a chunk's job, returning its parse error */
+char* lload_free(lload_job* j){
+    char* err=j->err;
+    for (int i = 0; i < j->count; i++) lval_del(j->forms[i]);
+    free(j->forms);
+    if(j->bin) free(j->bin->data);
+    free(j->bin);
+    free(j->src);
+    free(j);
+    return err;
+}
+/* with --cache DIR the forms of each file loaded are kept in DIR in
+binary, like .pyc files, and a later load decodes them instead of
+reading the source. a cache file starts with the key it was made
+for: the grammar, the source's path, modification time and size.
+the forms follow the key, then the hash of the source they were
+read from and a checksum of the forms, 4 bytes each, and LEND. if
+the key or the source's hash has changed it is written again, and
+one which doesn't check out is removed */
+#define LCACHE_VERSION 2
+#define LCACHE_TAIL 12
+
+/* a cache file being written, and the checksum of the forms in it */
+typedef struct {
+    FILE* f;
+    char* tmp;
+    unsigned long sum;
+} lcache;
+
+void lcache_put32(char* p,unsigned long x){
+    for (int i = 0; i < 4; i++) p[i]=(char)(x>>(8*i));
+}
+unsigned long lcache_get32(char* p){
+    unsigned long x=0;
+    for (int i = 0; i < 4; i++) x|=(unsigned long)(unsigned char)p[i]<<(8*i);
+    return x;
+}
+/* the key for the source open as f, and the hash of its bytes up to
+any zero byte, as the stream reads them. f is left at the start.
+0 if f can't be sized or read again */
+int lcache_key(FILE* f,char* filename,lbuf* key,unsigned long* hash){
+    struct stat st;
+    if(fstat(fileno(f),&st)!=0||!S_ISREG(st.st_mode)) return 0;
+    unsigned long h=LHASH_START;
+    char* buf=malloc(LSTREAM_CHUNK);
+    long n;
+    while((n=fread(buf,1,LSTREAM_CHUNK,f))>0){
+        char* z=memchr(buf,'\0',n);
+        if(z) n=z-buf;
+        h=lcache_hash(h,buf,n);
+        if(z) break;
+    }
+    free(buf);
+    if(ferror(f)||fseek(f,0,SEEK_SET)!=0) return 0;
+    *hash=h;
+    lbuf_put(key,"LSPC",4);
+    lbuf_put_uint(key,LCACHE_VERSION);
+    lbuf_put_uint(key,lispy_grammar_hash(lispy_grammar));
+    lbuf_put_text(key,filename);
+    lbuf_put_uint(key,(unsigned long)st.st_mtime);
+    lbuf_put_uint(key,(unsigned long)st.st_size);
+    return 1;
+}
+char* lcache_path(lispy* l,char* filename){
+    char* path=malloc(strlen(l->cache_dir)+32);
+    sprintf(path,"%s/%08lx.lspc",l->cache_dir,lispy_grammar_hash(filename));
+    return path;
+}
+/* map a whole file, or read it in where there is no mmap */
+char* lfile_map(char* path,long* len){
+    struct stat st;
+    if(stat(path,&st)!=0||st.st_size==0) return NULL;
+    *len=st.st_size;
+#ifdef _WIN32
+    FILE* f=fopen(path,"rb");
+    if(!f) return NULL;
+    char* data=malloc(*len);
+    if(fread(data,1,*len,f)!=(size_t)*len){
+        free(data);
+        data=NULL;
+    }
+    fclose(f);
+#else
+    int fd=open(path,O_RDONLY);
+    if(fd<0) return NULL;
+    char* data=mmap(NULL,*len,PROT_READ,MAP_PRIVATE,fd,0);
+    if(data==MAP_FAILED) data=NULL;
+    close(fd);
+#endif
+    return data;
+}
+void lfile_unmap(char* data,long len){
+#ifdef _WIN32
+    free(data);
+#else
+    munmap(data,len);
+#endif
+}
+/* decode the forms cached for a file, or NULL if there is no cache
+file for it as it is now. nothing is evaluated until all of them
+have decoded, and a cache file which is cut short, fails its
+checksum or doesn't decode is removed */
+lval* lcache_read(lispy* l,char* filename,lbuf* key,unsigned long hash){
+    char* path=lcache_path(l,filename);
+    long len;
+    char* data=lfile_map(path,&len);
+    if(!data){
+        free(path);
+        return NULL;
+    }
+    lval* forms=NULL;
+    /* made for another key, or from a source since changed: it is
+    written again */
+    int mine=len>=key->len+LCACHE_TAIL&&memcmp(data,key->data,key->len)==0;
+    if(mine&&lcache_get32(data+len-LCACHE_TAIL)==hash){
+        char* p=data+key->len;
+        char* end=data+len-LCACHE_TAIL;
+        if(memcmp(data+len-4,"LEND",4)==0
+            &&lcache_get32(data+len-8)==lcache_hash(LHASH_START,p,end-p)){
+            forms=lval_sexpr(l);
+            while(forms&&p<end){
+                lval* x=lval_read_bin(l,&p,end);
+                if(x) forms=lval_add(l,forms,x);
+                else{
+                    lval_del(forms);
+                    forms=NULL;
+                }
+            }
+        }
+        if(!forms) remove(path);
+    }
+    lfile_unmap(data,len);
+    free(path);
+    return forms;
+}
+/* evaluate the forms cached for a file, returning 0 if there
+is no good cache file for it as it is now */
+int lcache_load(lenv* e,char* filename,lbuf* key,unsigned long hash){
+    lval* forms=lcache_read(e->l,filename,key,hash);
+    if(!forms) return 0;
+    for (int i = 0; i < forms->count; i++){
+        lval_load_eval(e,forms->cell[i]);
+    }
+    forms->count=0;
+    lval_del(forms);
+    return 1;
+}
+/* the cache file is written beside its final name and moved
+there once the whole file has been read */
+int lcache_begin(lispy* l,lcache* c,char* filename,lbuf* key){
+    mkdir(l->cache_dir,0777);
+    char* path=lcache_path(l,filename);
+    c->tmp=malloc(strlen(path)+32);
+    sprintf(c->tmp,"%s.%d.tmp",path,(int)getpid());
+    free(path);
+    c->f=fopen(c->tmp,"wb");
+    if(!c->f){
+        free(c->tmp);
+        return 0;
+    }
+    fwrite(key->data,1,key->len,c->f);
+    c->sum=LHASH_START;
+    return 1;
+}
+void lcache_write(lcache* c,char* data,long len){
+    fwrite(data,1,len,c->f);
+    c->sum=lcache_hash(c->sum,data,len);
+}
+/* hash is that of the source bytes the forms were read from */
+void lcache_end(lispy* l,lcache* c,char* filename,unsigned long hash,int ok){
+    if(ok){
+        char tail[LCACHE_TAIL];
+        lcache_put32(tail,hash);
+        lcache_put32(tail+4,c->sum);
+        memcpy(tail+8,"LEND",4);
+        fwrite(tail,1,LCACHE_TAIL,c->f);
+    }
+    ok=!ferror(c->f)&&ok;
+    fclose(c->f);
+    if(ok){
+        char* path=lcache_path(l,filename);
+#ifdef _WIN32
+        remove(path);
+#endif
+        if(rename(c->tmp,path)!=0) remove(c->tmp);
+        free(path);
+    }else{
+        remove(c->tmp);
+    }
+    free(c->tmp);
+}
+
+/* images: --save-image writes the global environment once the files
+given are loaded, and --image starts from one instead of the builtins,
+so nothing has to be read or evaluated again. an image is LSPI, its
+version and the environment in binary, which holds no addresses */
+#define LIMAGE_VERSION 1
+
+int lenv_save_image(lenv* e,char* path){
+    lbuf b={0};
+    lbuf_put(&b,"LSPI",4);
+    lbuf_put_uint(&b,LIMAGE_VERSION);
+    lenv_write_bin(&b,e);
+    FILE* f=fopen(path,"wb");
+    int ok=f&&fwrite(b.data,1,b.len,f)==(size_t)b.len;
+    if(f&&fclose(f)!=0) ok=0;
+    free(b.data);
+    return ok;
+}
+lenv* lenv_load_image(lispy* l,char* path){
+    long len;
+    char* data=lfile_map(path,&len);
+    if(!data) return NULL;
+    char* p=data+4;
+    char* end=data+len;
+    unsigned long version;
+    lenv* e=NULL;
+    if(len>4&&memcmp(data,"LSPI",4)==0&&lbuf_get_uint(&p,end,&version)
+        &&version==LIMAGE_VERSION){
+        e=lenv_read_bin(l,&p,end);
+        if(e&&p!=end){
+            lenv_del(e);
+            e=NULL;
+        }
+    }
+    lfile_unmap(data,len);
+    return e;
+}
+
+/* load a file, or standard input for "-". returns
+the parse error which stopped it, if any */
+char* lval_load(lenv* e,char* filename){
+    lstream s={0};
+    s.hash=LHASH_START;
+    s.f=strcmp(filename,"-")==0 ? stdin : fopen(filename,"rb");
+    if(!s.f){
+        /* as mpc reports it */
+        char* err=malloc(strlen(filename)+32);
+        sprintf(err,"%s: error: Unable to open file!\n",filename);
+        return err;
+    }
 
-    /* Read contents */
-    lval* expr = lval_read(r.output);
-    mpc_ast_delete(r.output);
+    /* the key is taken from the open file, and the hash written with
+    the forms is of the bytes the stream read, so a file changed
+    while it loads is cached as it was read */
+    lcache c;
+    lcache* cache=NULL;
+    if(e->l->cache_dir&&s.f!=stdin){
+        lbuf key={0};
+        unsigned long hash;
+        if(lcache_key(s.f,filename,&key,&hash)){
+            if(lcache_load(e,filename,&key,hash)){
+                free(key.data);
+                fclose(s.f);
+                return NULL;
+            }
+            if(lcache_begin(e->l,&c,filename,&key)) cache=&c;
+        }
+        free(key.data);
+    }
 
-    /* Evaluate each Expression */
-    while (expr->count) {
-      lval* x = lval_eval(e, lval_pop(expr, 0));
-      /* If Evaluation leads to error print it */
-      if (x->type == LVAL_ERR) { lval_println(x); }
-      lval_del(x);
+    /* chunks read ahead of the one being evaluated */
+    int ahead=e->l->loader ? 2*e->l->loader->num : 0;
+    lload_job* first=NULL;
+    lload_job* last=NULL;
+    int queued=0,more=1;
+    char* err=NULL;
+    while(!err&&(more||first)){
+        while(more&&queued<=ahead){
+            lstream_scan(&s);
+            if(s.eof) s.cut=s.len;
+            if(s.cut==0){
+                if(s.eof){
+                    more=0;
+                    break;
+                }
+                lstream_fill(&s);
+                continue;
+            }
+            lload_job* j=lload_submit(e,&s,filename,cache!=NULL);
+            if(last) last->after=j;
+            else first=j;
+            last=j;
+            queued++;
+            lstream_drop(&s,s.cut);
+        }
+        if(!first) break;
+        lload_job* j=first;
+        first=j->after;
+        if(!first) last=NULL;
+        queued--;
+        lload_wait(j);
+        for (int i = 0; i < j->count; i++){
+            lval_load_eval(e,j->forms[i]);
+        }
+        j->count=0;
+        if(cache) lcache_write(cache,j->bin->data,j->bin->len);
+        err=lload_free(j);
     }
+    /* after an error, drop what was read ahead */
+    while(first){
+        lload_job* j=first;
+        first=j->after;
+        lload_wait(j);
+        free(lload_free(j));
+    }
+
+    if(s.f!=stdin) fclose(s.f);
+    free(s.buf);
+    /* a file which didn't read is not cached */
+    if(cache) lcache_end(e->l,cache,filename,s.hash,!err);
+    return err;
+}
+
+lval* builtin_load(lenv* e,lval* a) {
+  LASSERT_NUM("load", a, 1);
+  LASSERT_TYPE("load", a, 0, LVAL_STR);
+
+  /* Load File given by string name, evaluating each Expression */
+  char* err_msg = lval_load(e, a->cell[0]->str);
+  if (!err_msg) {
 
-    /* Delete expressions and arguments */
-    lval_del(expr);
+    /* Delete arguments */
     lval_del(a);
 
     /* Return empty list */
-    return lval_sexpr();
+    return lval_sexpr(e->l);
 
   } else {
-    /* Get Parse Error as String */
-    char* err_msg = mpc_err_string(r.error);
-    mpc_err_delete(r.error);
-
-    /* Create new error message using it */
-    lval* err = lval_err("Could not load Library %s", err_msg);
+    /* Create new error message from the Parse Error */
+    lval* err = lval_err(e->l,"Could not load Library %s", err_msg);
     free(err_msg);
     lval_del(a);
 
@@ -864,122 +2139,1109 @@ lval* builtin_load(lenv* e,lval* a) {
 
 lval* builtin_print(lenv* e,lval* a){
     for(int i=0;i<a->count;i++){
-        lval_print(a->cell[i]);
-        putchar(' ');
+        lval_write(&e->l->out,a->cell[i]);
+        lbuf_putc(&e->l->out,' ');
     }
-    putchar('\n');
+    lbuf_putc(&e->l->out,'\n');
+    lout_done(e->l);
+    lval_del(a);
+    return lval_sexpr(e->l);
+}
+lval* builtin_to_string(lenv* e,lval* a){
+    LASSERT_NUM("to-string",a,1);
+
+    lbuf b={0};
+    lval_write(&b,a->cell[0]);
+    lbuf_putc(&b,'\0');
     lval_del(a);
-    return lval_sexpr();
+    return lval_str_take(e->l,b.data);
+}
+/* (with-timeout ms {expr}) evaluates expr, ending it with an error if
+it runs for longer than ms milliseconds, or past any outer deadline */
+lval* builtin_with_timeout(lenv* e,lval* a){
+    LASSERT_NUM("with-timeout",a,2);
+    LASSERT_TYPE("with-timeout",a,0,LVAL_NUM);
+    LASSERT_TYPE("with-timeout",a,1,LVAL_QEXPR);
+
+    lispy* l=e->l;
+    double outer=l->deadline;
+    double d=lclock()+a->cell[0]->num/1000.0;
+    if(!outer||d<outer) l->deadline=d;
+    lval* x=lval_pop(a,1);
+    x->type=LVAL_SEXPR;
+    lval_del(a);
+    x=lval_eval(e,x);
+    /* only this deadline ends here, the evaluation around it goes on */
+    if(l->stop==LSTOP_TIME&&l->deadline!=outer&&(!outer||lclock()<=outer)){
+        l->stop=0;
+        l->fuel=0;
+    }
+    l->deadline=outer;
+    return x;
 }
 lval* builtin_error(lenv* e,lval* a){
     LASSERT_NUM("error",a,1);
     LASSERT_TYPE("error",a,0,LVAL_STR);
 
-    lval* err=lval_err(a->cell[0]->str);
+    lval* err=lval_err(e->l,a->cell[0]->str);
     lval_del(a);
     return err;
 }
 
+/* values as strings end at the first zero byte, so in those
+a 1 byte is written as 1 1, and a zero byte as 1 2 */
+lval* builtin_serialize(lenv* e,lval* a){
+    LASSERT_NUM("serialize",a,1);
+
+    lbuf b={0};
+    lval_write_bin(&b,a->cell[0]);
+    lval_del(a);
+    long n=b.len;
+    for (long i = 0; i < b.len; i++){
+        if((unsigned char)b.data[i]<2) n++;
+    }
+    lval* v=lval_str_take(e->l,malloc(n+1));
+    char* s=v->str;
+    for (long i = 0; i < b.len; i++){
+        if((unsigned char)b.data[i]<2){
+            *s++=1;
+            *s++=b.data[i]+1;
+        }else{
+            *s++=b.data[i];
+        }
+    }
+    *s='\0';
+    free(b.data);
+    return v;
+}
+/* read a whole value from bytes, or return an error */
+lval* lval_read_bin_all(lispy* l,char* p,char* end,char* func){
+    lval* x=lval_read_bin(l,&p,end);
+    if(x&&p==end) return x;
+    if(x) lval_del(x);
+    return lval_err(l,"Function '%s' passed invalid serialized data.",func);
+}
+lval* builtin_deserialize(lenv* e,lval* a){
+    LASSERT_NUM("deserialize",a,1);
+    LASSERT_TYPE("deserialize",a,0,LVAL_STR);
+
+    /* undo the escapes in place, as the result is never longer */
+    char* s=a->cell[0]->str;
+    char* t=s;
+    for (; *s; s++){
+        if(*s==1){
+            if(s[1]!=1&&s[1]!=2) break;
+            s++;
+            *t++=*s-1;
+        }else{
+            *t++=*s;
+        }
+    }
+    lval* x=*s ? lval_err(e->l,"Function 'deserialize' passed invalid serialized data.")
+        : lval_read_bin_all(e->l,a->cell[0]->str,t,"deserialize");
+    lval_del(a);
+    return x;
+}
+/* files hold LSPV and the value, unescaped */
+lval* builtin_serialize_file(lenv* e,lval* a){
+    LASSERT_NUM("serialize-file",a,2);
+    LASSERT_TYPE("serialize-file",a,0,LVAL_STR);
+
+    lbuf b={0};
+    lbuf_put(&b,"LSPV",4);
+    lval_write_bin(&b,a->cell[1]);
+    FILE* f=fopen(a->cell[0]->str,"wb");
+    int ok=f&&fwrite(b.data,1,b.len,f)==(size_t)b.len;
+    if(f&&fclose(f)!=0) ok=0;
+    free(b.data);
+    lval* x=ok ? lval_sexpr(e->l)
+        : lval_err(e->l,"Could not write file %s",a->cell[0]->str);
+    lval_del(a);
+    return x;
+}
+lval* builtin_deserialize_file(lenv* e,lval* a){
+    LASSERT_NUM("deserialize-file",a,1);
+    LASSERT_TYPE("deserialize-file",a,0,LVAL_STR);
+
+    long len;
+    char* data=lfile_map(a->cell[0]->str,&len);
+    lval* x;
+    if(!data){
+        x=lval_err(e->l,"Could not read file %s",a->cell[0]->str);
+    }else if(len<4||memcmp(data,"LSPV",4)!=0){
+        x=lval_err(e->l,"Function 'deserialize-file' passed invalid serialized data.");
+    }else{
+        x=lval_read_bin_all(e->l,data+4,data+len,"deserialize-file");
+    }
+    if(data) lfile_unmap(data,len);
+    lval_del(a);
+    return x;
+}
+
 /* register builtins with environment */
 void lenv_add_builtin(lenv* e,char* name,lbuiltin func){
-    lval* k=lval_sym(name);
-    lval* v=lval_fun(func);
+    lval* k=lval_sym(e->l,name);
+    lval* v=lval_fun(e->l,func);
     lenv_put(e,k,v);
 
     lval_del(k);
     lval_del(v);
 }
-void lenv_add_builtins(lenv* e){
+/* every builtin by the name it is bound to. images and binary
+values refer to builtins by name, as their addresses change from
+one build or run to the next */
+typedef struct {
+    char* name;
+    lbuiltin func;
+} lbuiltin_entry;
+
+lbuiltin_entry lbuiltins[]={
     /* list functions */
-    lenv_add_builtin(e,"list",builtin_list);
-    lenv_add_builtin(e,"head",builtin_head);
-    lenv_add_builtin(e,"tail",builtin_tail);
-    lenv_add_builtin(e,"eval",builtin_eval);
-    lenv_add_builtin(e,"join",builtin_join);
+    {"list",builtin_list},
+    {"head",builtin_head},
+    {"tail",builtin_tail},
+    {"eval",builtin_eval},
+    {"join",builtin_join},
     /* mathematical functions */
-    lenv_add_builtin(e,"+",builtin_add);
-    lenv_add_builtin(e,"-",builtin_sub);
-    lenv_add_builtin(e,"*",builtin_mul);
-    lenv_add_builtin(e,"/",builtin_div);
+    {"+",builtin_add},
+    {"-",builtin_sub},
+    {"*",builtin_mul},
+    {"/",builtin_div},
     /* variable functions */
-    lenv_add_builtin(e,"def",builtin_def);
-    lenv_add_builtin(e,"=",builtin_put);
-    lenv_add_builtin(e,"\\",builtin_lambda);
+    {"def",builtin_def},
+    {"=",builtin_put},
+    {"\\",builtin_lambda},
     /* comparison functions */
-    lenv_add_builtin(e,"if",builtin_if);
-    lenv_add_builtin(e,"==",builtin_eq);
-    lenv_add_builtin(e,"!=",builtin_ne);
-    lenv_add_builtin(e,">",builtin_gt);
-    lenv_add_builtin(e,"<",builtin_lt);
-    lenv_add_builtin(e,">=",builtin_ge);
-    lenv_add_builtin(e,"<=",builtin_le);
+    {"if",builtin_if},
+    {"==",builtin_eq},
+    {"!=",builtin_ne},
+    {">",builtin_gt},
+    {"<",builtin_lt},
+    {">=",builtin_ge},
+    {"<=",builtin_le},
+
+    {"load",builtin_load},
+    {"error",builtin_error},
+    {"with-timeout",builtin_with_timeout},
+    {"print",builtin_print},
+    {"to-string",builtin_to_string},
+    /* binary functions */
+    {"serialize",builtin_serialize},
+    {"deserialize",builtin_deserialize},
+    {"serialize-file",builtin_serialize_file},
+    {"deserialize-file",builtin_deserialize_file},
+    {NULL,NULL}
+};
+
+void lenv_add_builtins(lenv* e){
+    for (lbuiltin_entry* b = lbuiltins; b->name; b++){
+        lenv_add_builtin(e,b->name,b->func);
+    }
+}
+char* lbuiltin_name(lbuiltin func){
+    for (lbuiltin_entry* b = lbuiltins; b->name; b++){
+        if(b->func==func) return b->name;
+    }
+    return "";
+}
+lbuiltin lbuiltin_find(char* name){
+    for (lbuiltin_entry* b = lbuiltins; b->name; b++){
+        if(strcmp(b->name,name)==0) return b->func;
+    }
+    return NULL;
+}
+
+/* interpreters */
+lispy* lispy_new(void){
+    lispy* l=calloc(1,sizeof(lispy));
+    lgrammar_new(&l->grammar);
+    lispy_grammar_define(&l->grammar);
+    l->reader=mpc_context_new();
+    l->steps=l->room=LONG_MAX;
+    l->env=lenv_new(l);
+    lenv_add_builtins(l->env);
+    return l;
+}
+void lispy_free(lispy* l){
+    /* what it printed is written out, not lost with it */
+    if(l->out.len) lout_flush(l);
+    lenv_del(l->env);
+    if(l->loader) lload_pool_del(l->loader);
+    mpc_context_delete(l->reader);
+    lgrammar_del(&l->grammar);
+    free(l->out.data);
+    free(l);
+}
+/* evaluate each form in turn, giving the value of the last or the
+first error */
+lval* lval_eval_forms(lenv* e,lval* x){
+    lval* r=lval_sexpr(e->l);
+    llimit_begin(e->l);
+    while(x->count){
+        lval_del(r);
+        r=lval_eval(e,lval_pop(x,0));
+        if(r->type==LVAL_ERR) break;
+    }
+    llimit_end(e->l);
+    lval_del(x);
+    return r;
+}
+
+/* embedding, see lispy.h */
+lval* lispy_load(lispy* l,char* filename){
+    return builtin_load(l->env,lval_add(l,lval_sexpr(l),lval_str(l,filename)));
+}
+lval* lispy_read(lispy* l,char* src){
+    /* the reader writes into the source as it goes */
+    char* s=malloc(strlen(src)+1);
+    strcpy(s,src);
+    char* err;
+    lval* x=lval_read_source(l,"<string>",s,&err);
+    free(s);
+    if(!x){
+        size_t n=strlen(err);
+        if(n&&err[n-1]=='\n') err[n-1]='\0';
+        x=lval_err(l,"%s",err);
+        free(err);
+    }
+    return x;
+}
+lval* lispy_eval_string(lispy* l,char* src){
+    lval* x=lispy_read(l,src);
+    if(x->type==LVAL_ERR) return x;
+    return lval_eval_forms(l->env,x);
+}
+lval* lispy_eval_form(lispy* l,lval* forms){
+    if(forms->type!=LVAL_SEXPR) return lval_copy(l,forms);
+    return lval_eval_forms(l->env,lval_copy(l,forms));
+}
+void lispy_flush(lispy* l){
+    lout_flush(l);
+}
+int lispy_type(lval* v){
+    return v->type;
+}
+long lispy_num(lval* v){
+    return v->num;
+}
+char* lispy_str(lval* v){
+    switch(v->type){
+        case LVAL_STR: return v->str;
+        case LVAL_SYM: return v->sym;
+        case LVAL_ERR: return v->err;
+    }
+    return NULL;
+}
+int lispy_count(lval* v){
+    return v->count;
+}
+lval* lispy_cell(lval* v,int i){
+    return v->cell[i];
+}
+void lispy_limit(lispy* l,long steps,long bytes){
+    l->max_steps=steps;
+    l->max_bytes=bytes;
+}
+void lispy_timeout(lispy* l,long ms){
+    l->max_ms=ms;
+}
+void lispy_interrupt(lispy* l){
+    l->interrupt=1;
+}
+void lispy_add_builtin(lispy* l,char* name,lbuiltin func){
+    lenv_add_builtin(l->env,name,func);
+}
+lispy* lispy_of(lenv* e){
+    return e->l;
+}
+
+/* line mode */
+/* lispy -n -e '(\ {line} {...})' calls the function on every line of
+standard input, given as a string without its newline. a string result
+is written as it is, () writes nothing and anything else is printed */
+#define LLINE_CHUNK 65536
+
+typedef struct{
+    lval* f;
+    /* the formal of a one argument lambda, which is called directly */
+    lval* sym;
+    int errors;
+}lline;
 
-    lenv_add_builtin(e, "load",  builtin_load);
-    lenv_add_builtin(e, "error", builtin_error);
-    lenv_add_builtin(e, "print", builtin_print);
+void lline_prepare(lline* p,lval* f){
+    p->f=f;
+    p->sym=NULL;
+    p->errors=0;
+    if(!f->builtin&&f->formals->count==1
+        &&strcmp(f->formals->cell[0]->sym,"&")!=0){
+        p->sym=f->formals->cell[0];
+    }
 }
+void lline_call(lenv* e,lline* p,char* s,size_t n){
+    lispy* l=e->l;
+    char* str=lalloc(l,n+1);
+    memcpy(str,s,n);
+    str[n]='\0';
+    lval* line=lval_str_take(l,str);
 
+    lval* x;
+    llimit_begin(l);
+    if(p->sym){
+        /* what lval_call does, without copying the formals and the body
+        twice for every line */
+        lenv* env=lenv_copy(p->f->env);
+        env->par=e;
+        lenv_put(env,p->sym,line);
+        lval_del(line);
+        x=builtin_eval(env,lval_add(l,lval_sexpr(l),lval_copy(l,p->f->body)));
+        lenv_del(env);
+    }else{
+        lval* f=lval_copy(l,p->f);
+        x=lval_call(e,f,lval_add(l,lval_sexpr(l),line));
+        lval_del(f);
+    }
+    llimit_end(l);
+
+    if(x->type==LVAL_STR){
+        lbuf_puts(&l->out,x->str);
+        lbuf_putc(&l->out,'\n');
+    }else if(x->type!=LVAL_SEXPR||x->count!=0){
+        if(x->type==LVAL_ERR) p->errors++;
+        lval_write(&l->out,x);
+        lbuf_putc(&l->out,'\n');
+    }
+    lout_done(l);
+    lval_del(x);
+}
+/* returns the number of lines the function gave an error for */
+int lline_run(lenv* e,lval* f){
+    lline p;
+    lline_prepare(&p,f);
+
+    size_t cap=LLINE_CHUNK,len=0,n;
+    char* buf=malloc(cap);
+    while((n=fread(buf+len,1,cap-len,stdin))>0){
+        char* s=buf;
+        char* end=buf+len+n;
+        char* nl;
+        while((nl=memchr(s,'\n',end-s))){
+            lline_call(e,&p,s,nl-s);
+            s=nl+1;
+        }
+        /* keep the unfinished line, making room if it fills the buffer */
+        len=end-s;
+        memmove(buf,s,len);
+        if(len==cap){
+            cap*=2;
+            buf=realloc(buf,cap);
+        }
+    }
+    if(len) lline_call(e,&p,buf,len);
+    free(buf);
+    return p.errors;
+}
+/* evaluate the source given with -e. with -n it must give a function,
+which is run over standard input */
+int lline_main(lispy* l,char* src,int lines){
+    char* err;
+    lval* x=lval_read_source(l,"<-e>",src,&err);
+    if(!x){
+        lbuf_puts(&l->out,err);
+        free(err);
+        return 0;
+    }
+    llimit_begin(l);
+    x=lval_eval(l->env,x);
+    llimit_end(l);
+    int ok=x->type!=LVAL_ERR;
+    if(!lines||!ok){
+        lval_println(l,x);
+    }else if(x->type!=LVAL_FUN){
+        lbuf_puts(&l->out,"Error:-n needs a function. Got ");
+        lbuf_puts(&l->out,ltype_name(x->type));
+        lbuf_puts(&l->out,".\n");
+        ok=0;
+    }else{
+        ok=lline_run(l->env,x)==0;
+    }
+    lval_del(x);
+    return ok;
+}
+
+/* everything on standard input */
+char* lread_stdin(void){
+    size_t cap=LLINE_CHUNK,len=0,n;
+    char* s=malloc(cap+1);
+    while((n=fread(s+len,1,cap-len,stdin))>0){
+        len+=n;
+        if(len==cap){
+            cap*=2;
+            s=realloc(s,cap+1);
+        }
+    }
+    s[len]='\0';
+    return s;
+}
+
+/* server */
+/* lispy --serve PATH keeps one environment, with the builtins and the
+files given, and answers requests on a unix socket. a request and its
+answer are each a 4 byte big endian length and then that many bytes:
+source in, and what it printed followed by the value of its last form
+out. each request runs in an env of its own over the shared one, so
+anything it defines is gone when it ends. each connection is answered
+by a process of its own, forked from the server, so a slow or idle
+client holds up no other, and a request that runs for more than
+LSERVE_TIMEOUT ms, unless --timeout says otherwise, ends with an error */
+#define LSERVE_MAX (1<<24)
+#define LSERVE_TIMEOUT 10000
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <errno.h>
+
+int lfd_write(int fd,char* data,size_t len){
+    while(len){
+        ssize_t n=write(fd,data,len);
+        if(n<0&&errno==EINTR) continue;
+        if(n<=0) return 0;
+        data+=n;
+        len-=n;
+    }
+    return 1;
+}
+int lfd_read(int fd,char* data,size_t len){
+    while(len){
+        ssize_t n=read(fd,data,len);
+        if(n<0&&errno==EINTR) continue;
+        if(n<=0) return 0;
+        data+=n;
+        len-=n;
+    }
+    return 1;
+}
+int lframe_write(int fd,char* data,size_t len){
+    unsigned char h[4]={len>>24,len>>16,len>>8,len};
+    return lfd_write(fd,(char*)h,4)&&lfd_write(fd,data,len);
+}
+/* NULL at the end of the stream or on a bad frame */
+char* lframe_read(int fd,size_t* len){
+    unsigned char h[4];
+    if(!lfd_read(fd,(char*)h,4)) return NULL;
+    *len=(size_t)h[0]<<24|h[1]<<16|h[2]<<8|h[3];
+    if(*len>LSERVE_MAX) return NULL;
+    char* data=malloc(*len+1);
+    if(!lfd_read(fd,data,*len)){
+        free(data);
+        return NULL;
+    }
+    data[*len]='\0';
+    return data;
+}
+
+int lsock_addr(struct sockaddr_un* a,char* path){
+    memset(a,0,sizeof(*a));
+    a->sun_family=AF_UNIX;
+    if(strlen(path)>=sizeof(a->sun_path)) return 0;
+    strcpy(a->sun_path,path);
+    return 1;
+}
+int lsock_connect(char* path){
+    struct sockaddr_un a;
+    if(!lsock_addr(&a,path)) return -1;
+    int fd=socket(AF_UNIX,SOCK_STREAM,0);
+    if(fd<0) return -1;
+    if(connect(fd,(struct sockaddr*)&a,sizeof(a))<0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void lserve_request(lispy* l,char* src){
+    char* err;
+    lval* x=lval_read_source(l,"<request>",src,&err);
+    if(!x){
+        lbuf_puts(&l->out,err);
+        free(err);
+        return;
+    }
+    lenv* r=lenv_new(l);
+    r->par=l->env;
+    r->top=1;
+    x=lval_eval_forms(r,x);
+    lval_println(l,x);
+    lval_del(x);
+    lenv_del(r);
+}
+/* requests on one connection are answered in order until it closes */
+void lserve_conn(lispy* l,int fd){
+    size_t len;
+    char* src;
+    while((src=lframe_read(fd,&len))){
+        l->out.len=0;
+        lserve_request(l,src);
+        free(src);
+        if(!lframe_write(fd,l->out.data,l->out.len)) break;
+    }
+    l->out.len=0;
+    close(fd);
+}
+int lserve(lispy* l,char* path){
+    struct sockaddr_un a;
+    if(!lsock_addr(&a,path)){
+        printf("%s: error: Socket path too long!\n",path);
+        return 0;
+    }
+    int fd=socket(AF_UNIX,SOCK_STREAM,0);
+    /* only a socket, left by an earlier server, is replaced */
+    struct stat st;
+    if(lstat(path,&st)==0&&S_ISSOCK(st.st_mode)) unlink(path);
+    if(fd<0||bind(fd,(struct sockaddr*)&a,sizeof(a))<0||listen(fd,64)<0){
+        printf("%s: error: Unable to listen!\n",path);
+        return 0;
+    }
+    /* a client going away is not our problem, nor are the
+    connections' processes once they end */
+    signal(SIGPIPE,SIG_IGN);
+    signal(SIGCHLD,SIG_IGN);
+    if(!l->max_ms) l->max_ms=LSERVE_TIMEOUT;
+    lout_flush(l);
+    l->out_hold=1;
+    while(1){
+        int c=accept(fd,NULL,NULL);
+        if(c<0){
+            if(errno==EINTR) continue;
+            break;
+        }
+        pid_t pid=fork();
+        if(pid==0){
+            close(fd);
+            /* the loader's threads were not forked with us */
+            l->loader=NULL;
+            lserve_conn(l,c);
+            _exit(0);
+        }
+        close(c);
+    }
+    l->out_hold=0;
+    close(fd);
+    return 0;
+}
+
+int ldouble_cmp(const void* a,const void* b){
+    double x=*(double*)a,y=*(double*)b;
+    return x<y?-1:x>y;
+}
+/* send src, print the answer. with repeat above 1 the same request is
+sent that many times and the rate and latency are reported instead */
+int lclient(char* path,char* src,long repeat){
+    int fd=lsock_connect(path);
+    if(fd<0){
+        printf("%s: error: Unable to connect!\n",path);
+        return 0;
+    }
+    if(repeat<1) repeat=1;
+    double* lat=malloc(sizeof(double)*repeat);
+    double start=lclock();
+    int ok=1;
+    for(long i=0;i<repeat&&ok;i++){
+        double t=lclock();
+        size_t len;
+        char* out=NULL;
+        ok=lframe_write(fd,src,strlen(src))&&(out=lframe_read(fd,&len));
+        lat[i]=lclock()-t;
+        if(ok&&i==0&&repeat==1) fwrite(out,1,len,stdout);
+        free(out);
+    }
+    double total=lclock()-start;
+    close(fd);
+    if(!ok){
+        printf("%s: error: Connection lost!\n",path);
+    }else if(repeat>1){
+        qsort(lat,repeat,sizeof(double),ldouble_cmp);
+        printf("%ld requests in %.3fs, %.0f requests/s\n",
+            repeat,total,repeat/total);
+        printf("latency us: p50 %.1f p90 %.1f p99 %.1f max %.1f\n",
+            lat[repeat/2]*1e6,lat[repeat*9/10]*1e6,
+            lat[repeat*99/100]*1e6,lat[repeat-1]*1e6);
+    }
+    free(lat);
+    return ok;
+}
+
+/* worker pool */
+/* lispy [files] --workers N runs each line of standard input as a
+request, as the server would, on N forked processes which share the
+parent's set up environment until they write to it. each idle worker
+is handed one job on its own socket, so the parent always knows who
+holds which, answers come back on a pipe per worker and are printed
+in the order of the input. a job whose worker left before starting it
+is handed out again, and one a worker died in is answered with an
+error. with --max-jobs M a worker leaves after M jobs and a fresh one
+is forked from the parent */
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <poll.h>
+
+#define LPOOL_MAX 65536
+
+typedef struct{
+    pid_t pid;
+    /* jobs go out on in and answers come on fd, -1 when not running */
+    int in,fd;
+    /* the job handed to it or -1, whether it has started it, and
+    how many this process has answered */
+    long job;
+    int started;
+    long done;
+    /* stats over every process in this slot */
+    int procs;
+    long jobs;
+    double busy;
+    long rss;
+}lworker;
+
+/* a worker writes a type, a job and a length, then the data:
+'S' starting a job, 'A' its answer, 'T' stats as it leaves */
+int lworker_send(int fd,char type,unsigned long job,char* data,size_t len){
+    unsigned char h[9]={type,job>>24,job>>16,job>>8,job,
+        len>>24,len>>16,len>>8,len};
+    return lfd_write(fd,(char*)h,9)&&lfd_write(fd,data,len);
+}
+void lworker_run(lispy* l,int jobs,int out,long max){
+    char* buf=malloc(LPOOL_MAX+5);
+    long done=0;
+    double busy=0;
+    l->out_hold=1;
+    while(max<=0||done<max){
+        ssize_t n=recv(jobs,buf,LPOOL_MAX+4,0);
+        if(n<0&&errno==EINTR) continue;
+        if(n<4) break;
+        buf[n]='\0';
+        unsigned char* h=(unsigned char*)buf;
+        unsigned long job=(unsigned long)h[0]<<24|h[1]<<16|h[2]<<8|h[3];
+        if(!lworker_send(out,'S',job,NULL,0)) break;
+
+        double t=lclock();
+        l->out.len=0;
+        lserve_request(l,buf+4);
+        busy+=lclock()-t;
+        done++;
+        if(!lworker_send(out,'A',job,l->out.data,l->out.len)) break;
+    }
+    struct rusage u;
+    getrusage(RUSAGE_SELF,&u);
+    char s[64];
+    snprintf(s,sizeof(s),"%ld %f %ld",done,busy,(long)u.ru_maxrss);
+    lworker_send(out,'T',0,s,strlen(s));
+    free(buf);
+}
+/* start worker i of num in its slot */
+int lworker_start(lispy* l,lworker* ws,int num,int i,long max){
+    lworker* w=&ws[i];
+    int p[2],js[2];
+    if(pipe(p)<0) return 0;
+    if(socketpair(AF_UNIX,SOCK_SEQPACKET,0,js)<0){
+        close(p[0]);
+        close(p[1]);
+        return 0;
+    }
+    lout_flush(l);
+    pid_t pid=fork();
+    if(pid<0){
+        close(p[0]);
+        close(p[1]);
+        close(js[0]);
+        close(js[1]);
+        return 0;
+    }
+    if(pid==0){
+        close(p[0]);
+        close(js[0]);
+        /* the other workers see their jobs end when the parent
+        closes them, so none of theirs are kept open here */
+        for (int k = 0; k < num; k++){
+            if(k==i||ws[k].fd<0) continue;
+            close(ws[k].in);
+            close(ws[k].fd);
+        }
+        /* the loader's threads were not forked with us */
+        l->loader=NULL;
+        lworker_run(l,js[1],p[1],max);
+        _exit(0);
+    }
+    close(p[1]);
+    close(js[1]);
+    w->pid=pid;
+    w->in=js[0];
+    w->fd=p[0];
+    w->job=-1;
+    w->started=0;
+    w->done=0;
+    w->procs++;
+    return 1;
+}
+
+typedef struct{
+    char* data;
+    size_t len;
+    int done;
+    /* times it was handed out again */
+    int again;
+}lanswer;
+
+void lanswer_set(lanswer* a,char* data,size_t len){
+    a->data=data;
+    a->len=len;
+    a->done=1;
+}
+/* read one frame from a worker, 0 once it has gone */
+int lworker_read(lworker* w,lanswer* answers){
+    unsigned char h[9];
+    if(!lfd_read(w->fd,(char*)h,9)) return 0;
+    unsigned long job=(unsigned long)h[1]<<24|h[2]<<16|h[3]<<8|h[4];
+    size_t len=(size_t)h[5]<<24|h[6]<<16|h[7]<<8|h[8];
+    char* data=malloc(len+1);
+    if(!lfd_read(w->fd,data,len)){
+        free(data);
+        return 0;
+    }
+    data[len]='\0';
+    if(h[0]=='S'){
+        w->started=1;
+        free(data);
+    }else if(h[0]=='A'){
+        w->job=-1;
+        w->started=0;
+        w->done++;
+        lanswer_set(&answers[job],data,len);
+    }else{
+        long jobs=0,rss=0;
+        double busy=0;
+        sscanf(data,"%ld %lf %ld",&jobs,&busy,&rss);
+        w->jobs+=jobs;
+        w->busy+=busy;
+        if(rss>w->rss) w->rss=rss;
+        free(data);
+    }
+    return 1;
+}
+/* reap a worker whose pipe closed. a job it had not started goes back
+on again, once, and one it died in is answered for. 1 if it was */
+int lworker_end(lworker* w,lanswer* answers,long* again,int* nagain){
+    int status;
+    close(w->in);
+    close(w->fd);
+    w->fd=-1;
+    waitpid(w->pid,&status,0);
+    if(w->job<0) return 0;
+    if(!w->started&&!answers[w->job].again++){
+        again[(*nagain)++]=w->job;
+        w->job=-1;
+        return 0;
+    }
+    char* err=malloc(64);
+    snprintf(err,64,"Error:Worker %ld died.\n",(long)w->pid);
+    lanswer_set(&answers[w->job],err,strlen(err));
+    w->job=-1;
+    return 1;
+}
+
+int lpool_run(lispy* l,int num,long max){
+    /* the jobs, one per line */
+    char* src=lread_stdin();
+    long count=0,slots=0;
+    char** jobs=NULL;
+    for(char* s=src;*s;){
+        char* nl=strchr(s,'\n');
+        if(count==slots){
+            slots=slots?slots*2:64;
+            jobs=realloc(jobs,sizeof(char*)*slots);
+        }
+        jobs[count++]=s;
+        if(!nl) break;
+        *nl='\0';
+        s=nl+1;
+    }
+
+    signal(SIGPIPE,SIG_IGN);
+    lworker* w=calloc(num,sizeof(lworker));
+    for(int i=0;i<num;i++) w[i].fd=-1;
+    for(int i=0;i<num;i++) lworker_start(l,w,num,i,max);
+    lanswer* answers=calloc(count?count:1,sizeof(lanswer));
+    struct pollfd* fds=malloc(sizeof(struct pollfd)*num);
+    char* msg=malloc(LPOOL_MAX+4);
+    /* jobs handed out again, at most one per worker */
+    long* again=malloc(sizeof(long)*num);
+    int nagain=0;
+    long sent=0,answered=0,printed=0;
+    double start=lclock();
+    int ok=1;
+
+    while(printed<count){
+        /* hand each idle worker the next job, unless it is about to
+        leave after its last */
+        for(int i=0;i<num;i++){
+            if(w[i].fd<0||w[i].job>=0||(max>0&&w[i].done>=max)) continue;
+            long j=-1;
+            while(j<0&&(nagain||sent<count)){
+                j=nagain?again[--nagain]:sent++;
+                size_t n=strlen(jobs[j]);
+                if(n>LPOOL_MAX){
+                    char* err=malloc(64);
+                    strcpy(err,"Error:Job too long.\n");
+                    lanswer_set(&answers[j],err,strlen(err));
+                    answered++;
+                    j=-1;
+                }
+            }
+            if(j<0) break;
+            size_t n=strlen(jobs[j]);
+            unsigned char h[4]={j>>24,j>>16,j>>8,j};
+            memcpy(msg,h,4);
+            memcpy(msg+4,jobs[j],n);
+            /* if this fails the worker has gone, and its pipe says so */
+            w[i].job=j;
+            w[i].started=0;
+            send(w[i].in,msg,n+4,0);
+        }
+        int running=0;
+        for(int i=0;i<num;i++){
+            fds[i].fd=w[i].fd;
+            fds[i].events=POLLIN;
+            running+=w[i].fd>=0;
+        }
+        if(!running){
+            puts("Error:Unable to start workers!");
+            ok=0;
+            break;
+        }
+        if(poll(fds,num,-1)<0){
+            if(errno==EINTR) continue;
+            ok=0;
+            break;
+        }
+        for(int i=0;i<num;i++){
+            if(w[i].fd<0||!(fds[i].revents&(POLLIN|POLLHUP))) continue;
+            int was=w[i].job>=0&&!answers[w[i].job].done;
+            if(lworker_read(&w[i],answers)){
+                if(was&&w[i].job<0) answered++;
+                continue;
+            }
+            answered+=lworker_end(&w[i],answers,again,&nagain);
+            /* replace it while there is work left */
+            if(answered<count) lworker_start(l,w,num,i,max);
+        }
+        /* print answers as soon as the ones before them are in */
+        while(printed<count&&answers[printed].done){
+            lbuf_put(&l->out,answers[printed].data,answers[printed].len);
+            free(answers[printed].data);
+            printed++;
+            lout_done(l);
+        }
+    }
+    lout_flush(l);
+
+    /* no more jobs, let the workers leave with their stats */
+    for(int i=0;i<num;i++){
+        if(w[i].fd<0) continue;
+        shutdown(w[i].in,SHUT_WR);
+        while(lworker_read(&w[i],answers));
+        lworker_end(&w[i],answers,again,&nagain);
+    }
+    double total=lclock()-start;
+    for(int i=0;i<num;i++){
+        fprintf(stderr,"worker %d: %d processes, %ld jobs, %.3fs busy, "
+            "%ldKB max rss\n",i,w[i].procs,w[i].jobs,w[i].busy,w[i].rss);
+    }
+    fprintf(stderr,"%ld jobs in %.3fs, %.0f jobs/s\n",
+        count,total,total>0?count/total:0);
+
+    for(long i=printed;i<count;i++) free(answers[i].data);
+    free(answers);
+    free(fds);
+    free(msg);
+    free(again);
+    free(w);
+    free(jobs);
+    free(src);
+    return ok;
+}
+#else
+int lserve(lispy* l,char* path){
+    printf("%s: error: --serve needs unix sockets!\n",path);
+    return 0;
+}
+int lclient(char* path,char* src,long repeat){
+    printf("%s: error: --client needs unix sockets!\n",path);
+    return 0;
+}
+int lpool_run(lispy* l,int num,long max){
+    puts("Error:--workers needs fork!");
+    return 0;
+}
+#endif
+
+#ifndef LISPY_LIBRARY
+/* Ctrl-C while the REPL evaluates interrupts that, rather than ending
+the process as it does at the prompt */
+lispy* lrepl;
+void lrepl_sigint(int sig){
+    lispy_interrupt(lrepl);
+}
 int main(int argc, char **argv)
 {
-    /* create some parsers */
-    Number = mpc_new("number");
-    Symbol = mpc_new("symbol");
-    String =mpc_new("string");
-    Comment =mpc_new("comment");
-    Sexpr = mpc_new("sexpr");
-    Qexpr = mpc_new("qexpr");
-    Expr = mpc_new("expr");
-    Lispy = mpc_new("lispy");
-
-
-    mpca_lang(MPCA_LANG_DEFAULT,
-    "                                                           \
-        number:     /-?[0-9]+/ ;                                \
-        symbol:     /[a-zA-Z0-9_+\\-*\\/\\\\=<>!&]+/ ;          \
-        string:     /\"(\\\\.|[^\"])*\"/ ;                      \
-        comment:    /;[^\\r\\n]*/ ;                             \
-        sexpr:      '(' <expr>* ')' ;                           \
-        qexpr:      '{' <expr>* '}';                            \
-        expr:       <number> | <symbol> | <string> |            \
-                    <comment> | <sexpr> | <qexpr>;              \
-        lispy:      /^/ <expr>* /$/ ;                           \
-    ",
-    Number, Symbol, String, Comment, Sexpr, Qexpr, Expr, Lispy);
+    /* options, everything else is a file to load */
+    int files=0;
+    int mpc=0;
+    int jobs=0;
+    char* cache=NULL;
+    char* table=NULL;
+    char* image=NULL;
+    char* save_image=NULL;
+    char* expr=NULL;
+    int lines=0;
+    char* serve=NULL;
+    char* client=NULL;
+    long repeat=1;
+    int workers=0;
+    long max_jobs=0;
+    long max_steps=0;
+    long max_bytes=0;
+    long timeout=0;
+    for (int i = 1; i < argc; i++) {
+        if(strcmp(argv[i],"--mpc")==0){
+            mpc=1;
+        }else if(strcmp(argv[i],"--grammar-table")==0 && i+1<argc){
+            table=argv[++i];
+        }else if(strcmp(argv[i],"--jobs")==0 && i+1<argc){
+            jobs=atoi(argv[++i]);
+        }else if(strcmp(argv[i],"--cache")==0 && i+1<argc){
+            cache=argv[++i];
+        }else if(strcmp(argv[i],"--image")==0 && i+1<argc){
+            image=argv[++i];
+        }else if(strcmp(argv[i],"--save-image")==0 && i+1<argc){
+            save_image=argv[++i];
+        }else if(strcmp(argv[i],"-e")==0 && i+1<argc){
+            expr=argv[++i];
+        }else if(strcmp(argv[i],"-n")==0){
+            lines=1;
+        }else if(strcmp(argv[i],"--serve")==0 && i+1<argc){
+            serve=argv[++i];
+        }else if(strcmp(argv[i],"--client")==0 && i+1<argc){
+            client=argv[++i];
+        }else if(strcmp(argv[i],"--repeat")==0 && i+1<argc){
+            repeat=atol(argv[++i]);
+        }else if(strcmp(argv[i],"--workers")==0 && i+1<argc){
+            workers=atoi(argv[++i]);
+        }else if(strcmp(argv[i],"--max-jobs")==0 && i+1<argc){
+            max_jobs=atol(argv[++i]);
+        }else if(strcmp(argv[i],"--max-steps")==0 && i+1<argc){
+            max_steps=atol(argv[++i]);
+        }else if(strcmp(argv[i],"--max-bytes")==0 && i+1<argc){
+            max_bytes=atol(argv[++i]);
+        }else if(strcmp(argv[i],"--timeout")==0 && i+1<argc){
+            timeout=atol(argv[++i]);
+        }else{
+            files++;
+        }
+    }
 
-    lenv* e=lenv_new();
-    lenv_add_builtins(e);
-    if(argc==1){
+    if(table) return lispy_grammar_write(table)?0:1;
+    /* the client only talks to a server, it needs no interpreter */
+    if(client){
+        char* src=expr?expr:lread_stdin();
+        int ok=lclient(client,src,repeat);
+        if(!expr) free(src);
+        return ok?0:1;
+    }
+    if(lines&&!expr){
+        puts("-n needs -e EXPR");
+        return 1;
+    }
+    lispy* l=lispy_new();
+    l->read_with_mpc=mpc;
+    l->cache_dir=cache;
+    /* limits on each top-level form, or each request when serving */
+    lispy_limit(l,max_steps,max_bytes);
+    lispy_timeout(l,timeout);
+    /* read files on this many threads while the main one evaluates */
+    if(jobs>0) l->loader=lload_pool_new(jobs);
+    if(image){
+        lenv* e=lenv_load_image(l,image);
+        if(!e){
+            printf("%s: error: Unable to load image!\n",image);
+            lispy_free(l);
+            return 1;
+        }
+        lenv_del(l->env);
+        l->env=e;
+    }
+    if(files==0&&!save_image&&!expr&&!serve&&!workers){
+        lrepl=l;
         puts("Lispy Version 0.0.1");
         puts("Press Ctrl+c to Exit\n");
         while(1){
+            lout_flush(l);
             char *input = readline("lispy> ");
             add_history(input);
 
-            /* attempt to parse the user input */
-            mpc_result_t r;
-            if(mpc_parse("<stdin>",input,Lispy,&r)){
-                lval* x=lval_eval(e,lval_read(r.output));
-                lval_println(x);
+            /* attempt to read the user input */
+            char* err;
+            lval* x=lval_read_source(l,"<stdin>",input,&err);
+            if(x){
+                signal(SIGINT,lrepl_sigint);
+                llimit_begin(l);
+                x=lval_eval(l->env,x);
+                llimit_end(l);
+                signal(SIGINT,SIG_DFL);
+                lval_println(l,x);
                 lval_del(x);
             }else{
-                mpc_err_print(r.error);
-                mpc_err_delete(r.error);
+                lbuf_puts(&l->out,err);
+                free(err);
             }
             
             free(input);
         }
     }
-    if(argc>=2){
+    if(files>0){
         for (int i = 1; i < argc; i++) {
-            lval* args = lval_add(lval_sexpr(), lval_str(argv[i]));
-            lval* x = builtin_load(e, args);
-            if(x->type == LVAL_ERR) { lval_println(x); }
+            if(strcmp(argv[i],"--mpc")==0) continue;
+            if(strcmp(argv[i],"--grammar-table")==0){ i++; continue; }
+            if(strcmp(argv[i],"--jobs")==0){ i++; continue; }
+            if(strcmp(argv[i],"--cache")==0){ i++; continue; }
+            if(strcmp(argv[i],"--image")==0){ i++; continue; }
+            if(strcmp(argv[i],"--save-image")==0){ i++; continue; }
+            if(strcmp(argv[i],"-e")==0){ i++; continue; }
+            if(strcmp(argv[i],"-n")==0) continue;
+            if(strcmp(argv[i],"--serve")==0){ i++; continue; }
+            if(strcmp(argv[i],"--client")==0){ i++; continue; }
+            if(strcmp(argv[i],"--repeat")==0){ i++; continue; }
+            if(strcmp(argv[i],"--workers")==0){ i++; continue; }
+            if(strcmp(argv[i],"--max-jobs")==0){ i++; continue; }
+            if(strcmp(argv[i],"--max-steps")==0){ i++; continue; }
+            if(strcmp(argv[i],"--max-bytes")==0){ i++; continue; }
+            if(strcmp(argv[i],"--timeout")==0){ i++; continue; }
+            lval* args = lval_add(l,lval_sexpr(l), lval_str(l,argv[i]));
+            lval* x = builtin_load(l->env, args);
+            if(x->type == LVAL_ERR) { lval_println(l,x); }
             lval_del(x);
         }
     }
+    int ok=1;
+    if(expr) ok=lline_main(l,expr,lines);
+    if(serve) ok=lserve(l,serve);
+    if(workers>0) ok=lpool_run(l,workers,max_jobs);
+    lout_flush(l);
+    if(save_image&&!lenv_save_image(l->env,save_image)){
+        printf("%s: error: Unable to write image!\n",save_image);
+        ok=0;
+    }
 
-    lenv_del(e);
-    mpc_cleanup(8,Number,Symbol,String,Comment,Sexpr,Qexpr,Expr,Lispy);
-
-    return 0;
-}
\ No newline at end of file
+    lispy_free(l);
+    return ok?0:1;
+}
+#endif
\ No newline at end of file
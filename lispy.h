@@ -0,0 +1,70 @@
+/* lispy.h: running lispy inside a C program. lispy.c built with
+LISPY_LIBRARY defined leaves out main, and is linked with mpc.c */
+#ifndef lispy_h
+#define lispy_h
+
+/* an interpreter, a value and an environment. values belong to the
+interpreter that made them, and are freed with lval_del */
+typedef struct lispy lispy;
+typedef struct lval lval;
+typedef struct lenv lenv;
+/* a builtin gets the environment it is called in and its arguments,
+which it frees, and returns a new value */
+typedef lval*(*lbuiltin)(lenv*,lval*);
+
+enum {LVAL_ERR,LVAL_NUM,LVAL_SYM,LVAL_STR,
+    LVAL_FUN,LVAL_SEXPR,LVAL_QEXPR};
+
+/* an interpreter with the builtins bound. each one is independent,
+so threads may each run their own. lispy_free writes out whatever it
+still holds printed before freeing it */
+lispy* lispy_new(void);
+void lispy_free(lispy* l);
+
+/* these evaluate in the global environment and return a new value,
+which is an LVAL_ERR if reading or evaluating failed */
+lval* lispy_load(lispy* l,char* filename);
+lval* lispy_eval_string(lispy* l,char* src);
+/* read source once into its forms, for lispy_eval_form to evaluate
+in order, giving the last value, as often as needed. the forms are
+left as they are */
+lval* lispy_read(lispy* l,char* src);
+lval* lispy_eval_form(lispy* l,lval* forms);
+/* limit each evaluation above to so many steps, and to allocating so
+many bytes in all, 0 for no limit. going over either ends it with an
+error. loads limit each top-level form of the file separately */
+void lispy_limit(lispy* l,long steps,long bytes);
+/* end each evaluation above that runs for longer than ms milliseconds
+with an error, 0 for no deadline */
+void lispy_timeout(lispy* l,long ms);
+/* end the evaluation running now with an error. safe to call from a
+signal handler or another thread */
+void lispy_interrupt(lispy* l);
+/* printing is buffered until this, or until enough is held */
+void lispy_flush(lispy* l);
+
+/* what a value holds, without copying. lispy_str is the text of
+a string, symbol or error, and the cells are those of an S-Expression
+or Q-Expression. all of it belongs to v */
+int lispy_type(lval* v);
+long lispy_num(lval* v);
+char* lispy_str(lval* v);
+int lispy_count(lval* v);
+lval* lispy_cell(lval* v,int i);
+
+/* bind a C function in the global environment. images and serialized
+values refer to builtins by name, so ones holding a host builtin can't
+be read back */
+void lispy_add_builtin(lispy* l,char* name,lbuiltin func);
+/* the interpreter a builtin is running in, to make its result with */
+lispy* lispy_of(lenv* e);
+lval* lval_num(lispy* l,long x);
+lval* lval_str(lispy* l,char* s);
+lval* lval_err(lispy* l,char* fmt,...);
+lval* lval_sexpr(lispy* l);
+lval* lval_qexpr(lispy* l);
+lval* lval_add(lispy* l,lval* v,lval* x);
+lval* lval_copy(lispy* l,lval* v);
+void lval_del(lval* v);
+
+#endif
@@ -0,0 +1,2002 @@
+/* generated by lispy --grammar-table, do not edit */
+#define LISPY_GRAMMAR_HASH 0x0c4141f9UL
+static const unsigned char lispy_grammar_table[] = {
+  0x6d, 0x70, 0x63, 0x01, 0xd9, 0x01, 0x18, 0x01, 0x07, 0x6e, 0x75, 0x6d,
+  0x62, 0x65, 0x72, 0x02, 0x21, 0x01, 0x02, 0x01, 0x07, 0x00, 0x10, 0x00,
+  0x03, 0x23, 0x02, 0x02, 0x0f, 0x00, 0x04, 0x20, 0x18, 0x00, 0x02, 0x16,
+  0x05, 0x0c, 0x02, 0x18, 0x00, 0x02, 0x1d, 0x06, 0x09, 0x01, 0x13, 0x00,
+  0x07, 0x00, 0x04, 0x05, 0x00, 0x08, 0x04, 0x27, 0x2d, 0x27, 0x09, 0x00,
+  0x2d, 0x1d, 0x00, 0x01, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+  0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x05, 0x00, 0x0b, 0x14, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20,
+  0x27, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x27,
+  0x0a, 0x00, 0x0b, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38,
+  0x39, 0x05, 0x00, 0x0d, 0x0b, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70,
+  0x61, 0x63, 0x65, 0x0f, 0x00, 0x0e, 0x05, 0x05, 0x00, 0x0f, 0x07, 0x73,
+  0x70, 0x61, 0x63, 0x65, 0x73, 0x1d, 0x00, 0x00, 0x10, 0x00, 0x3e, 0x00,
+  0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x11, 0x0b, 0x77, 0x68, 0x69,
+  0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x00, 0x12, 0x10, 0x6f,
+  0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09,
+  0x0b, 0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18,
+  0x01, 0x07, 0x73, 0x79, 0x6d, 0x62, 0x6f, 0x6c, 0x02, 0x21, 0x14, 0x15,
+  0x01, 0x07, 0x00, 0x10, 0x00, 0x16, 0x23, 0x02, 0x02, 0x0f, 0x00, 0x17,
+  0x20, 0x18, 0x00, 0x02, 0x16, 0x18, 0x1b, 0x02, 0x1d, 0x00, 0x01, 0x19,
+  0x00, 0x00, 0x00, 0x00, 0x42, 0xac, 0xff, 0x73, 0xfe, 0xff, 0xff, 0x97,
+  0xfe, 0xff, 0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x1a, 0x53,
+  0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x61, 0x62, 0x63, 0x64,
+  0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70,
+  0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x41, 0x42,
+  0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e,
+  0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+  0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x5f, 0x2b,
+  0x2d, 0x2a, 0x2f, 0x5c, 0x3d, 0x3c, 0x3e, 0x21, 0x26, 0x27, 0x0a, 0x00,
+  0x4a, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b,
+  0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+  0x78, 0x79, 0x7a, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+  0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55,
+  0x56, 0x57, 0x58, 0x59, 0x5a, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36,
+  0x37, 0x38, 0x39, 0x5f, 0x2b, 0x2d, 0x2a, 0x2f, 0x5c, 0x3d, 0x3c, 0x3e,
+  0x21, 0x26, 0x05, 0x00, 0x1c, 0x0b, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73,
+  0x70, 0x61, 0x63, 0x65, 0x0f, 0x00, 0x1d, 0x05, 0x05, 0x00, 0x1e, 0x07,
+  0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x1d, 0x00, 0x00, 0x1f, 0x00, 0x3e,
+  0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x20, 0x0b, 0x77, 0x68,
+  0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x00, 0x21, 0x10,
+  0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d,
+  0x09, 0x0b, 0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b,
+  0x18, 0x01, 0x07, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x02, 0x21, 0x23,
+  0x24, 0x01, 0x07, 0x00, 0x10, 0x00, 0x25, 0x23, 0x02, 0x02, 0x0f, 0x00,
+  0x26, 0x20, 0x18, 0x00, 0x02, 0x16, 0x27, 0x36, 0x02, 0x18, 0x00, 0x03,
+  0x1d, 0x28, 0x2a, 0x34, 0x01, 0x01, 0x05, 0x00, 0x29, 0x04, 0x27, 0x22,
+  0x27, 0x09, 0x00, 0x22, 0x1d, 0x00, 0x00, 0x2b, 0xfe, 0xff, 0xff, 0xff,
+  0xfb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0x17, 0x00, 0x02, 0x2c, 0x32, 0x01, 0x00, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x00, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xff, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x18, 0x00, 0x02, 0x1d, 0x2d, 0x2f, 0x01, 0x05, 0x00, 0x2e,
+  0x04, 0x27, 0x5c, 0x27, 0x09, 0x00, 0x5c, 0x05, 0x00, 0x30, 0x1f, 0x61,
+  0x6e, 0x79, 0x20, 0x63, 0x68, 0x61, 0x72, 0x61, 0x63, 0x74, 0x65, 0x72,
+  0x20, 0x65, 0x78, 0x63, 0x65, 0x70, 0x74, 0x20, 0x61, 0x20, 0x6e, 0x65,
+  0x77, 0x6c, 0x69, 0x6e, 0x65, 0x05, 0x00, 0x31, 0x0c, 0x6e, 0x6f, 0x6e,
+  0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x0a, 0x27, 0x0b, 0x00, 0x02, 0x0a,
+  0x05, 0x00, 0x33, 0x0c, 0x6e, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20,
+  0x27, 0x22, 0x27, 0x0b, 0x00, 0x02, 0x22, 0x05, 0x00, 0x35, 0x04, 0x27,
+  0x22, 0x27, 0x09, 0x00, 0x22, 0x05, 0x00, 0x37, 0x0b, 0x77, 0x68, 0x69,
+  0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x00, 0x38, 0x05, 0x05,
+  0x00, 0x39, 0x07, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x1d, 0x00, 0x00,
+  0x3a, 0x00, 0x3e, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x3b,
+  0x0b, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05,
+  0x00, 0x3c, 0x10, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20,
+  0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a,
+  0x0d, 0x09, 0x0b, 0x18, 0x01, 0x08, 0x63, 0x6f, 0x6d, 0x6d, 0x65, 0x6e,
+  0x74, 0x02, 0x21, 0x3e, 0x3f, 0x01, 0x07, 0x00, 0x10, 0x00, 0x40, 0x23,
+  0x02, 0x02, 0x0f, 0x00, 0x41, 0x20, 0x18, 0x00, 0x02, 0x16, 0x42, 0x48,
+  0x02, 0x18, 0x00, 0x02, 0x1d, 0x43, 0x45, 0x01, 0x05, 0x00, 0x44, 0x04,
+  0x27, 0x3b, 0x27, 0x09, 0x00, 0x3b, 0x1d, 0x00, 0x00, 0x46, 0xfe, 0xdb,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x05, 0x00, 0x47, 0x0d, 0x6e, 0x6f,
+  0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x0d, 0x0a, 0x27, 0x0b, 0x00,
+  0x03, 0x0d, 0x0a, 0x05, 0x00, 0x49, 0x0b, 0x77, 0x68, 0x69, 0x74, 0x65,
+  0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x00, 0x4a, 0x05, 0x05, 0x00, 0x4b,
+  0x07, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x1d, 0x00, 0x00, 0x4c, 0x00,
+  0x3e, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x4d, 0x0b, 0x77,
+  0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x00, 0x4e,
+  0x10, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a,
+  0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a, 0x0d, 0x09,
+  0x0b, 0x18, 0x01, 0x06, 0x73, 0x65, 0x78, 0x70, 0x72, 0x03, 0x1f, 0x50,
+  0x5e, 0x9e, 0x01, 0x22, 0x22, 0x18, 0x00, 0x02, 0x21, 0x51, 0x52, 0x01,
+  0x07, 0x00, 0x10, 0x00, 0x53, 0x23, 0x02, 0x01, 0x0f, 0x00, 0x54, 0x20,
+  0x18, 0x00, 0x02, 0x16, 0x55, 0x57, 0x02, 0x05, 0x00, 0x56, 0x04, 0x27,
+  0x28, 0x27, 0x09, 0x00, 0x28, 0x05, 0x00, 0x58, 0x0b, 0x77, 0x68, 0x69,
+  0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x00, 0x59, 0x05, 0x05,
+  0x00, 0x5a, 0x07, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x1d, 0x00, 0x00,
+  0x5b, 0x00, 0x3e, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x5c,
+  0x0b, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05,
+  0x00, 0x5d, 0x10, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20,
+  0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a,
+  0x0d, 0x09, 0x0b, 0x14, 0x00, 0x00, 0x1f, 0x5f, 0x00, 0x18, 0x00, 0x02,
+  0x21, 0x60, 0x61, 0x01, 0x07, 0x00, 0x0f, 0x00, 0x62, 0x25, 0x10, 0x00,
+  0x63, 0x24, 0x01, 0x63, 0x17, 0x01, 0x05, 0x65, 0x78, 0x70, 0x72, 0x06,
+  0x64, 0x68, 0x6c, 0x70, 0x74, 0x78, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x05,
+  0x00, 0x02, 0x02, 0x00, 0xff, 0x00, 0x02, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x04, 0x02, 0x02, 0x02, 0x00, 0x00,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x00, 0x02, 0x00, 0x00, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x06, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18,
+  0x00, 0x02, 0x21, 0x65, 0x66, 0x01, 0x07, 0x00, 0x0f, 0x00, 0x67, 0x25,
+  0x10, 0x00, 0x00, 0x24, 0x01, 0x00, 0x18, 0x00, 0x02, 0x21, 0x69, 0x6a,
+  0x01, 0x07, 0x00, 0x0f, 0x00, 0x6b, 0x25, 0x10, 0x00, 0x13, 0x24, 0x01,
+  0x13, 0x18, 0x00, 0x02, 0x21, 0x6d, 0x6e, 0x01, 0x07, 0x00, 0x0f, 0x00,
+  0x6f, 0x25, 0x10, 0x00, 0x22, 0x24, 0x01, 0x22, 0x18, 0x00, 0x02, 0x21,
+  0x71, 0x72, 0x01, 0x07, 0x00, 0x0f, 0x00, 0x73, 0x25, 0x10, 0x00, 0x3d,
+  0x24, 0x01, 0x3d, 0x18, 0x00, 0x02, 0x21, 0x75, 0x76, 0x01, 0x07, 0x00,
+  0x0f, 0x00, 0x77, 0x25, 0x10, 0x00, 0x4f, 0x24, 0x01, 0x4f, 0x18, 0x00,
+  0x02, 0x21, 0x79, 0x7a, 0x01, 0x07, 0x00, 0x0f, 0x00, 0x7b, 0x25, 0x10,
+  0x00, 0x7c, 0x24, 0x01, 0x7c, 0x18, 0x01, 0x06, 0x71, 0x65, 0x78, 0x70,
+  0x72, 0x03, 0x1f, 0x7d, 0x8b, 0x01, 0x90, 0x01, 0x22, 0x22, 0x18, 0x00,
+  0x02, 0x21, 0x7e, 0x7f, 0x01, 0x07, 0x00, 0x10, 0x00, 0x80, 0x01, 0x23,
+  0x02, 0x01, 0x0f, 0x00, 0x81, 0x01, 0x20, 0x18, 0x00, 0x02, 0x16, 0x82,
+  0x01, 0x84, 0x01, 0x02, 0x05, 0x00, 0x83, 0x01, 0x04, 0x27, 0x7b, 0x27,
+  0x09, 0x00, 0x7b, 0x05, 0x00, 0x85, 0x01, 0x0b, 0x77, 0x68, 0x69, 0x74,
+  0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x00, 0x86, 0x01, 0x05, 0x05,
+  0x00, 0x87, 0x01, 0x07, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x1d, 0x00,
+  0x00, 0x88, 0x01, 0x00, 0x3e, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05,
+  0x00, 0x89, 0x01, 0x0b, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61,
+  0x63, 0x65, 0x05, 0x00, 0x8a, 0x01, 0x10, 0x6f, 0x6e, 0x65, 0x20, 0x6f,
+  0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x00,
+  0x07, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x14, 0x00, 0x00, 0x1f, 0x8c,
+  0x01, 0x00, 0x18, 0x00, 0x02, 0x21, 0x8d, 0x01, 0x8e, 0x01, 0x01, 0x07,
+  0x00, 0x0f, 0x00, 0x8f, 0x01, 0x25, 0x10, 0x00, 0x63, 0x24, 0x01, 0x63,
+  0x18, 0x00, 0x02, 0x21, 0x91, 0x01, 0x92, 0x01, 0x01, 0x07, 0x00, 0x10,
+  0x00, 0x93, 0x01, 0x23, 0x02, 0x01, 0x0f, 0x00, 0x94, 0x01, 0x20, 0x18,
+  0x00, 0x02, 0x16, 0x95, 0x01, 0x97, 0x01, 0x02, 0x05, 0x00, 0x96, 0x01,
+  0x04, 0x27, 0x7d, 0x27, 0x09, 0x00, 0x7d, 0x05, 0x00, 0x98, 0x01, 0x0b,
+  0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x00,
+  0x99, 0x01, 0x05, 0x05, 0x00, 0x9a, 0x01, 0x07, 0x73, 0x70, 0x61, 0x63,
+  0x65, 0x73, 0x1d, 0x00, 0x00, 0x9b, 0x01, 0x00, 0x3e, 0x00, 0x00, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x05, 0x00, 0x9c, 0x01, 0x0b, 0x77, 0x68, 0x69, 0x74,
+  0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x00, 0x9d, 0x01, 0x10, 0x6f,
+  0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09,
+  0x0b, 0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18,
+  0x00, 0x02, 0x21, 0x9f, 0x01, 0xa0, 0x01, 0x01, 0x07, 0x00, 0x10, 0x00,
+  0xa1, 0x01, 0x23, 0x02, 0x01, 0x0f, 0x00, 0xa2, 0x01, 0x20, 0x18, 0x00,
+  0x02, 0x16, 0xa3, 0x01, 0xa5, 0x01, 0x02, 0x05, 0x00, 0xa4, 0x01, 0x04,
+  0x27, 0x29, 0x27, 0x09, 0x00, 0x29, 0x05, 0x00, 0xa6, 0x01, 0x0b, 0x77,
+  0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x00, 0xa7,
+  0x01, 0x05, 0x05, 0x00, 0xa8, 0x01, 0x07, 0x73, 0x70, 0x61, 0x63, 0x65,
+  0x73, 0x1d, 0x00, 0x00, 0xa9, 0x01, 0x00, 0x3e, 0x00, 0x00, 0x01, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x05, 0x00, 0xaa, 0x01, 0x0b, 0x77, 0x68, 0x69, 0x74, 0x65,
+  0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x00, 0xab, 0x01, 0x10, 0x6f, 0x6e,
+  0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b,
+  0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18, 0x01,
+  0x06, 0x6c, 0x69, 0x73, 0x70, 0x79, 0x03, 0x1f, 0xad, 0x01, 0xbd, 0x01,
+  0xc2, 0x01, 0x22, 0x22, 0x18, 0x00, 0x02, 0x21, 0xae, 0x01, 0xaf, 0x01,
+  0x01, 0x07, 0x00, 0x10, 0x00, 0xb0, 0x01, 0x23, 0x02, 0x02, 0x0f, 0x00,
+  0xb1, 0x01, 0x20, 0x18, 0x00, 0x02, 0x16, 0xb2, 0x01, 0xb6, 0x01, 0x02,
+  0x18, 0x00, 0x02, 0x17, 0xb3, 0x01, 0xb5, 0x01, 0x01, 0x05, 0x00, 0xb4,
+  0x01, 0x0f, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x6f, 0x66, 0x20, 0x69,
+  0x6e, 0x70, 0x75, 0x74, 0x1b, 0x00, 0x03, 0x00, 0x04, 0x05, 0x00, 0xb7,
+  0x01, 0x0b, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65,
+  0x0f, 0x00, 0xb8, 0x01, 0x05, 0x05, 0x00, 0xb9, 0x01, 0x07, 0x73, 0x70,
+  0x61, 0x63, 0x65, 0x73, 0x1d, 0x00, 0x00, 0xba, 0x01, 0x00, 0x3e, 0x00,
+  0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0xbb, 0x01, 0x0b, 0x77, 0x68,
+  0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x00, 0xbc, 0x01,
+  0x10, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a,
+  0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a, 0x0d, 0x09,
+  0x0b, 0x14, 0x00, 0x00, 0x1f, 0xbe, 0x01, 0x00, 0x18, 0x00, 0x02, 0x21,
+  0xbf, 0x01, 0xc0, 0x01, 0x01, 0x07, 0x00, 0x0f, 0x00, 0xc1, 0x01, 0x25,
+  0x10, 0x00, 0x63, 0x24, 0x01, 0x63, 0x18, 0x00, 0x02, 0x21, 0xc3, 0x01,
+  0xc4, 0x01, 0x01, 0x07, 0x00, 0x10, 0x00, 0xc5, 0x01, 0x23, 0x02, 0x02,
+  0x0f, 0x00, 0xc6, 0x01, 0x20, 0x18, 0x00, 0x02, 0x16, 0xc7, 0x01, 0xd2,
+  0x01, 0x02, 0x17, 0x00, 0x02, 0xc8, 0x01, 0xce, 0x01, 0x00, 0x18, 0x00,
+  0x02, 0x16, 0xc9, 0x01, 0xcc, 0x01, 0x01, 0x05, 0x00, 0xca, 0x01, 0x08,
+  0x6e, 0x65, 0x77, 0x6c, 0x69, 0x6e, 0x65, 0x05, 0x00, 0xcb, 0x01, 0x04,
+  0x27, 0x0a, 0x27, 0x09, 0x00, 0x0a, 0x05, 0x00, 0xcd, 0x01, 0x0d, 0x65,
+  0x6e, 0x64, 0x20, 0x6f, 0x66, 0x20, 0x69, 0x6e, 0x70, 0x75, 0x74, 0x1c,
+  0x00, 0x18, 0x00, 0x02, 0x17, 0xcf, 0x01, 0xd1, 0x01, 0x01, 0x05, 0x00,
+  0xd0, 0x01, 0x0d, 0x65, 0x6e, 0x64, 0x20, 0x6f, 0x66, 0x20, 0x69, 0x6e,
+  0x70, 0x75, 0x74, 0x1c, 0x00, 0x03, 0x00, 0x04, 0x05, 0x00, 0xd3, 0x01,
+  0x0b, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f,
+  0x00, 0xd4, 0x01, 0x05, 0x05, 0x00, 0xd5, 0x01, 0x07, 0x73, 0x70, 0x61,
+  0x63, 0x65, 0x73, 0x1d, 0x00, 0x00, 0xd6, 0x01, 0x00, 0x3e, 0x00, 0x00,
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0xd7, 0x01, 0x0b, 0x77, 0x68, 0x69,
+  0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x00, 0xd8, 0x01, 0x10,
+  0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d,
+  0x09, 0x0b, 0x27, 0x0a, 0x00, 0x07, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b
+};
+
+typedef struct {
+  const char *s;
+  long pos;
+  int term, bt, sup;
+  long rpos, row, col;
+  int max;
+  mpc_arena_t *arena;
+} lispy_grammar_parse_ctx_t;
+
+static int lispy_grammar_parse_in(const unsigned char *set, char x) {
+  return (set[(unsigned char)x / 8] >> ((unsigned char)x % 8)) & 1;
+}
+
+static char *lispy_grammar_parse_chr(lispy_grammar_parse_ctx_t *c) {
+  char *o = malloc(2);
+  o[0] = c->s[c->pos++];
+  o[1] = '\0';
+  return o;
+}
+
+static mpc_state_t *lispy_grammar_parse_state(lispy_grammar_parse_ctx_t *c) {
+  mpc_state_t *s = malloc(sizeof(mpc_state_t));
+  if (c->pos < c->rpos) { c->rpos = 0; c->row = 0; c->col = 0; }
+  for (; c->rpos < c->pos; c->rpos++) {
+    if (c->s[c->rpos] == '\n') { c->row++; c->col = 0; } else { c->col++; }
+  }
+  s->pos = c->pos;
+  s->row = c->row;
+  s->col = c->col;
+  s->term = c->term;
+  return s;
+}
+
+static mpc_val_t *lispy_grammar_parse_str_ast(lispy_grammar_parse_ctx_t *c, mpc_val_t *x) {
+  mpc_ast_t *a;
+  if (c->arena == NULL) { return mpcf_str_ast(x); }
+  a = mpc_arena_ast_new(c->arena, "", x);
+  free(x);
+  return a;
+}
+
+static void lispy_grammar_parse_cat(char **b, size_t *l, size_t *m, const char *x, size_t n) {
+  if (*b == NULL || *l + n + 1 > *m) {
+    *m = (*l + n + 1) * 2;
+    *b = realloc(*b, *m);
+  }
+  memcpy(*b + *l, x, n);
+  *l += n;
+  (*b)[*l] = '\0';
+}
+
+static void lispy_grammar_parse_push(mpc_val_t ***xs, int *n, int *m, mpc_val_t **s, mpc_val_t *x) {
+  if (*n == *m) {
+    *m *= 2;
+    if (*xs == s) {
+      *xs = malloc(sizeof(mpc_val_t*) * *m);
+      memcpy(*xs, s, sizeof(mpc_val_t*) * *n);
+    } else {
+      *xs = realloc(*xs, sizeof(mpc_val_t*) * *m);
+    }
+  }
+  (*xs)[(*n)++] = x;
+}
+
+static const unsigned char lispy_grammar_parse_set0[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set1[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_jump2[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 2, 3, 0, 0, 0, 2, 0, 5, 0, 2, 2, 0, 255, 0, 2, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0, 4, 2, 2, 2, 0,
+  0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 2, 0, 0, 2,
+  0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 6, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+static const unsigned char lispy_grammar_parse_set3[32] = { 0, 0, 0, 0, 0, 0, 255, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set4[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set5[32] = { 0, 0, 0, 0, 66, 172, 255, 115, 254, 255, 255, 151, 254, 255, 255, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set6[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set7[32] = { 254, 255, 255, 255, 251, 255, 255, 255, 255, 255, 255, 239, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 };
+static const unsigned char lispy_grammar_parse_jump8[256] = {
+  0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 255, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
+};
+static const unsigned char lispy_grammar_parse_set9[32] = { 254, 251, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 };
+static const unsigned char lispy_grammar_parse_set10[32] = { 254, 255, 255, 255, 251, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 };
+static const unsigned char lispy_grammar_parse_set11[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set12[32] = { 254, 219, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 };
+static const unsigned char lispy_grammar_parse_set13[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set14[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set15[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set16[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+static const unsigned char lispy_grammar_parse_set17[32] = { 0, 62, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+static int lispy_grammar_parse_0(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth);
+static int lispy_grammar_parse_22(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth);
+static int lispy_grammar_parse_27(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth);
+static int lispy_grammar_parse_50(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth);
+static int lispy_grammar_parse_69(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth);
+static int lispy_grammar_parse_100(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth);
+static int lispy_grammar_parse_122(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth);
+static int lispy_grammar_parse_160(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth);
+
+/* lispy */
+static int lispy_grammar_parse_0(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth) {
+  int ok0 = 0; mpc_val_t *v0 = NULL; long e0 = -1;
+  if (depth + 0 == c->max) { e0 = c->sup ? -1 : c->pos; } else {
+    long p0 = c->pos; int t0 = c->term; mpc_val_t *xs0[3];
+    do {
+      int ok1 = 0; mpc_val_t *v1 = NULL; long e1 = -1;
+      if (depth + 1 == c->max) { e1 = c->sup ? -1 : c->pos; } else {
+        long p1 = c->pos; int t1 = c->term; mpc_val_t *xs1[2];
+        do {
+          int ok2 = 0; mpc_val_t *v2 = NULL; long e2 = -1;
+          if (depth + 2 == c->max) { e2 = c->sup ? -1 : c->pos; } else {
+            ok2 = 1; v2 = lispy_grammar_parse_state(c);
+          }
+          if (!ok2) {
+            if (c->bt > 0) { c->pos = p1; c->term = t1; }
+            e1 = e2; break;
+          }
+          xs1[0] = v2;
+          int ok3 = 0; mpc_val_t *v3 = NULL; long e3 = -1;
+          if (depth + 2 == c->max) { e3 = c->sup ? -1 : c->pos; } else {
+            int ok4 = 0; mpc_val_t *v4 = NULL; long e4 = -1;
+            if (depth + 3 == c->max) { e4 = c->sup ? -1 : c->pos; } else {
+              int ok5 = 0; mpc_val_t *v5 = NULL; long e5 = -1;
+              if (depth + 4 == c->max) { e5 = c->sup ? -1 : c->pos; } else {
+                long p5 = c->pos; int t5 = c->term; mpc_val_t *xs5[2];
+                do {
+                  int ok6 = 0; mpc_val_t *v6 = NULL; long e6 = -1;
+                  if (depth + 5 == c->max) { e6 = c->sup ? -1 : c->pos; } else {
+                    long p6 = c->pos; int t6 = c->term; mpc_val_t *xs6[2];
+                    do {
+                      int ok7 = 0; mpc_val_t *v7 = NULL; long e7 = -1;
+                      if (depth + 6 == c->max) { e7 = c->sup ? -1 : c->pos; } else {
+                        c->sup++;
+                        int ok8 = 0; mpc_val_t *v8 = NULL; long e8 = -1;
+                        if (depth + 7 == c->max) { e8 = c->sup ? -1 : c->pos; } else {
+                          ok8 = c->pos == 0;
+                        }
+                        c->sup--; (void)e8;
+                        if (ok8) { ok7 = 1; v7 = v8; } else { e7 = c->sup ? -1 : c->pos; }
+                      }
+                      if (!ok7) {
+                        if (c->bt > 0) { c->pos = p6; c->term = t6; }
+                        e6 = e7; break;
+                      }
+                      xs6[0] = v7;
+                      int ok9 = 0; mpc_val_t *v9 = NULL; long e9 = -1;
+                      if (depth + 6 == c->max) { e9 = c->sup ? -1 : c->pos; } else {
+                        ok9 = 1; v9 = mpcf_ctor_str();
+                      }
+                      if (!ok9) {
+                        if (c->bt > 0) { c->pos = p6; c->term = t6; }
+                        free(xs6[0]);
+                        e6 = e9; break;
+                      }
+                      xs6[1] = v9;
+                      ok6 = 1; v6 = mpcf_snd(2, xs6);
+                    } while (0);
+                  }
+                  if (!ok6) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    e5 = e6; break;
+                  }
+                  xs5[0] = v6;
+                  int ok10 = 0; mpc_val_t *v10 = NULL; long e10 = -1;
+                  if (depth + 5 == c->max) { e10 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok11 = 0; mpc_val_t *v11 = NULL; long e11 = -1;
+                    if (depth + 6 == c->max) { e11 = c->sup ? -1 : c->pos; } else {
+                      int ok12 = 0; mpc_val_t *v12 = NULL; long e12 = -1;
+                      if (depth + 7 == c->max) { e12 = c->sup ? -1 : c->pos; } else {
+                        c->sup++;
+                        int ok13 = 0; mpc_val_t *v13 = NULL; long e13 = -1;
+                        if (depth + 8 == c->max) { e13 = c->sup ? -1 : c->pos; } else {
+                          char *b13 = NULL; size_t l13 = 0, m13 = 0; long j13 = 0, q13;
+                          for (;;) {
+                            for (q13 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set0, c->s[c->pos]); c->pos++);
+                            lispy_grammar_parse_cat(&b13, &l13, &m13, c->s + q13, c->pos - q13); j13 += c->pos - q13;
+                            e13 = c->sup ? -1 : c->pos;
+                            break;
+                          }
+                          if (j13 >= 0) { ok13 = 1; v13 = b13; e13 = -1; } else { free(b13); }
+                        }
+                        c->sup--; (void)e13;
+                        if (ok13) { ok12 = 1; v12 = v13; } else { e12 = c->sup ? -1 : c->pos; }
+                      }
+                      if (ok12) { ok11 = 1; v11 = mpcf_free(v12); } else { e11 = e12; }
+                    }
+                    c->sup--; (void)e11;
+                    if (ok11) { ok10 = 1; v10 = v11; } else { e10 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok10) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    mpcf_dtor_null(xs5[0]);
+                    e5 = e10; break;
+                  }
+                  xs5[1] = v10;
+                  ok5 = 1; v5 = mpcf_fst(2, xs5);
+                } while (0);
+              }
+              if (ok5) { ok4 = 1; v4 = lispy_grammar_parse_str_ast(c, v5); } else { e4 = e5; }
+            }
+            if (ok4) { ok3 = 1; v3 = mpc_ast_tag(v4, "regex"); } else { e3 = e4; }
+          }
+          if (!ok3) {
+            if (c->bt > 0) { c->pos = p1; c->term = t1; }
+            free(xs1[0]);
+            e1 = e3; break;
+          }
+          xs1[1] = v3;
+          ok1 = 1; v1 = mpcf_state_ast(2, xs1);
+        } while (0);
+      }
+      if (!ok1) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        e0 = e1; break;
+      }
+      xs0[0] = v1;
+      int ok14 = 0; mpc_val_t *v14 = NULL; long e14 = -1;
+      if (depth + 1 == c->max) { e14 = c->sup ? -1 : c->pos; } else {
+        mpc_val_t *s14[8], **xs14 = s14; int j14 = 0, m14 = 8;
+        for (;;) {
+          int ok15 = 0; mpc_val_t *v15 = NULL; long e15 = -1;
+          if (depth + 2 == c->max) { e15 = c->sup ? -1 : c->pos; } else {
+            long p15 = c->pos; int t15 = c->term; mpc_val_t *xs15[2];
+            do {
+              int ok16 = 0; mpc_val_t *v16 = NULL; long e16 = -1;
+              if (depth + 3 == c->max) { e16 = c->sup ? -1 : c->pos; } else {
+                ok16 = 1; v16 = lispy_grammar_parse_state(c);
+              }
+              if (!ok16) {
+                if (c->bt > 0) { c->pos = p15; c->term = t15; }
+                e15 = e16; break;
+              }
+              xs15[0] = v16;
+              int ok17 = 0; mpc_val_t *v17 = NULL; long e17 = -1;
+              if (depth + 3 == c->max) { e17 = c->sup ? -1 : c->pos; } else {
+                int ok18 = 0; mpc_val_t *v18 = NULL; long e18 = -1;
+                if (depth + 4 == c->max) { e18 = c->sup ? -1 : c->pos; } else {
+                  int ok19 = 0; mpc_val_t *v19 = NULL; long e19 = -1;
+                  ok19 = lispy_grammar_parse_22(c, &v19, &e19, depth + 5);
+                  if (ok19) { ok18 = 1; v18 = mpc_ast_add_tag(v19, "expr"); } else { e18 = e19; }
+                }
+                if (ok18) { ok17 = 1; v17 = mpc_ast_add_root(v18); } else { e17 = e18; }
+              }
+              if (!ok17) {
+                if (c->bt > 0) { c->pos = p15; c->term = t15; }
+                free(xs15[0]);
+                e15 = e17; break;
+              }
+              xs15[1] = v17;
+              ok15 = 1; v15 = mpcf_state_ast(2, xs15);
+            } while (0);
+          }
+          if (!ok15) { e14 = e15; break; }
+          lispy_grammar_parse_push(&xs14, &j14, &m14, s14, v15);
+        }
+        ok14 = 1; v14 = mpcf_fold_ast(j14, xs14);
+        if (xs14 != s14) { free(xs14); }
+      }
+      if (!ok14) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        mpc_ast_delete(xs0[0]);
+        e0 = e14; break;
+      }
+      xs0[1] = v14;
+      int ok20 = 0; mpc_val_t *v20 = NULL; long e20 = -1;
+      if (depth + 1 == c->max) { e20 = c->sup ? -1 : c->pos; } else {
+        long p20 = c->pos; int t20 = c->term; mpc_val_t *xs20[2];
+        do {
+          int ok21 = 0; mpc_val_t *v21 = NULL; long e21 = -1;
+          if (depth + 2 == c->max) { e21 = c->sup ? -1 : c->pos; } else {
+            ok21 = 1; v21 = lispy_grammar_parse_state(c);
+          }
+          if (!ok21) {
+            if (c->bt > 0) { c->pos = p20; c->term = t20; }
+            e20 = e21; break;
+          }
+          xs20[0] = v21;
+          int ok22 = 0; mpc_val_t *v22 = NULL; long e22 = -1;
+          if (depth + 2 == c->max) { e22 = c->sup ? -1 : c->pos; } else {
+            int ok23 = 0; mpc_val_t *v23 = NULL; long e23 = -1;
+            if (depth + 3 == c->max) { e23 = c->sup ? -1 : c->pos; } else {
+              int ok24 = 0; mpc_val_t *v24 = NULL; long e24 = -1;
+              if (depth + 4 == c->max) { e24 = c->sup ? -1 : c->pos; } else {
+                long p24 = c->pos; int t24 = c->term; mpc_val_t *xs24[2];
+                do {
+                  int ok25 = 0; mpc_val_t *v25 = NULL; long e25 = -1;
+                  if (depth + 5 == c->max) { e25 = c->sup ? -1 : c->pos; } else {
+                    int j25 = 0, only25 = 0; long s25 = c->pos;
+                    (void)s25;
+                    for (; j25 < 2; j25++) {
+                      int ok = 0; mpc_val_t *v = NULL; long e = -1;
+                      switch (j25) {
+                      case 0: {
+                        int ok26 = 0; mpc_val_t *v26 = NULL; long e26 = -1;
+                        if (depth + 6 == c->max) { e26 = c->sup ? -1 : c->pos; } else {
+                          long p26 = c->pos; int t26 = c->term; mpc_val_t *xs26[2];
+                          do {
+                            int ok27 = 0; mpc_val_t *v27 = NULL; long e27 = -1;
+                            if (depth + 7 == c->max) { e27 = c->sup ? -1 : c->pos; } else {
+                              c->sup++;
+                              int ok28 = 0; mpc_val_t *v28 = NULL; long e28 = -1;
+                              if (depth + 8 == c->max) { e28 = c->sup ? -1 : c->pos; } else {
+                                c->sup++;
+                                int ok29 = 0; mpc_val_t *v29 = NULL; long e29 = -1;
+                                if (depth + 9 == c->max) { e29 = c->sup ? -1 : c->pos; } else {
+                                  if (c->s[c->pos] == '\012') { ok29 = 1; v29 = lispy_grammar_parse_chr(c); }
+                                }
+                                c->sup--; (void)e29;
+                                if (ok29) { ok28 = 1; v28 = v29; } else { e28 = c->sup ? -1 : c->pos; }
+                              }
+                              c->sup--; (void)e28;
+                              if (ok28) { ok27 = 1; v27 = v28; } else { e27 = c->sup ? -1 : c->pos; }
+                            }
+                            if (!ok27) {
+                              if (c->bt > 0) { c->pos = p26; c->term = t26; }
+                              e26 = e27; break;
+                            }
+                            xs26[0] = v27;
+                            int ok30 = 0; mpc_val_t *v30 = NULL; long e30 = -1;
+                            if (depth + 7 == c->max) { e30 = c->sup ? -1 : c->pos; } else {
+                              c->sup++;
+                              int ok31 = 0; mpc_val_t *v31 = NULL; long e31 = -1;
+                              if (depth + 8 == c->max) { e31 = c->sup ? -1 : c->pos; } else {
+                                if (!c->term && !c->s[c->pos]) { c->term = 1; ok31 = 1; }
+                              }
+                              c->sup--; (void)e31;
+                              if (ok31) { ok30 = 1; v30 = v31; } else { e30 = c->sup ? -1 : c->pos; }
+                            }
+                            if (!ok30) {
+                              if (c->bt > 0) { c->pos = p26; c->term = t26; }
+                              free(xs26[0]);
+                              e26 = e30; break;
+                            }
+                            xs26[1] = v30;
+                            ok26 = 1; v26 = mpcf_fst(2, xs26);
+                          } while (0);
+                        }
+                        ok = ok26; v = v26; e = e26;
+                        break;
+                      }
+                      case 1: {
+                        int ok32 = 0; mpc_val_t *v32 = NULL; long e32 = -1;
+                        if (depth + 6 == c->max) { e32 = c->sup ? -1 : c->pos; } else {
+                          long p32 = c->pos; int t32 = c->term; mpc_val_t *xs32[2];
+                          do {
+                            int ok33 = 0; mpc_val_t *v33 = NULL; long e33 = -1;
+                            if (depth + 7 == c->max) { e33 = c->sup ? -1 : c->pos; } else {
+                              c->sup++;
+                              int ok34 = 0; mpc_val_t *v34 = NULL; long e34 = -1;
+                              if (depth + 8 == c->max) { e34 = c->sup ? -1 : c->pos; } else {
+                                if (!c->term && !c->s[c->pos]) { c->term = 1; ok34 = 1; }
+                              }
+                              c->sup--; (void)e34;
+                              if (ok34) { ok33 = 1; v33 = v34; } else { e33 = c->sup ? -1 : c->pos; }
+                            }
+                            if (!ok33) {
+                              if (c->bt > 0) { c->pos = p32; c->term = t32; }
+                              e32 = e33; break;
+                            }
+                            xs32[0] = v33;
+                            int ok35 = 0; mpc_val_t *v35 = NULL; long e35 = -1;
+                            if (depth + 7 == c->max) { e35 = c->sup ? -1 : c->pos; } else {
+                              ok35 = 1; v35 = mpcf_ctor_str();
+                            }
+                            if (!ok35) {
+                              if (c->bt > 0) { c->pos = p32; c->term = t32; }
+                              free(xs32[0]);
+                              e32 = e35; break;
+                            }
+                            xs32[1] = v35;
+                            ok32 = 1; v32 = mpcf_snd(2, xs32);
+                          } while (0);
+                        }
+                        ok = ok32; v = v32; e = e32;
+                        break;
+                      }
+                      }
+                      if (ok) { ok25 = 1; v25 = v; break; }
+                      if (only25) { if (e > s25) { break; } only25 = 0; j25 = -1; }
+                    }
+                  }
+                  if (!ok25) {
+                    if (c->bt > 0) { c->pos = p24; c->term = t24; }
+                    e24 = e25; break;
+                  }
+                  xs24[0] = v25;
+                  int ok36 = 0; mpc_val_t *v36 = NULL; long e36 = -1;
+                  if (depth + 5 == c->max) { e36 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok37 = 0; mpc_val_t *v37 = NULL; long e37 = -1;
+                    if (depth + 6 == c->max) { e37 = c->sup ? -1 : c->pos; } else {
+                      int ok38 = 0; mpc_val_t *v38 = NULL; long e38 = -1;
+                      if (depth + 7 == c->max) { e38 = c->sup ? -1 : c->pos; } else {
+                        c->sup++;
+                        int ok39 = 0; mpc_val_t *v39 = NULL; long e39 = -1;
+                        if (depth + 8 == c->max) { e39 = c->sup ? -1 : c->pos; } else {
+                          char *b39 = NULL; size_t l39 = 0, m39 = 0; long j39 = 0, q39;
+                          for (;;) {
+                            for (q39 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set1, c->s[c->pos]); c->pos++);
+                            lispy_grammar_parse_cat(&b39, &l39, &m39, c->s + q39, c->pos - q39); j39 += c->pos - q39;
+                            e39 = c->sup ? -1 : c->pos;
+                            break;
+                          }
+                          if (j39 >= 0) { ok39 = 1; v39 = b39; e39 = -1; } else { free(b39); }
+                        }
+                        c->sup--; (void)e39;
+                        if (ok39) { ok38 = 1; v38 = v39; } else { e38 = c->sup ? -1 : c->pos; }
+                      }
+                      if (ok38) { ok37 = 1; v37 = mpcf_free(v38); } else { e37 = e38; }
+                    }
+                    c->sup--; (void)e37;
+                    if (ok37) { ok36 = 1; v36 = v37; } else { e36 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok36) {
+                    if (c->bt > 0) { c->pos = p24; c->term = t24; }
+                    mpcf_dtor_null(xs24[0]);
+                    e24 = e36; break;
+                  }
+                  xs24[1] = v36;
+                  ok24 = 1; v24 = mpcf_fst(2, xs24);
+                } while (0);
+              }
+              if (ok24) { ok23 = 1; v23 = lispy_grammar_parse_str_ast(c, v24); } else { e23 = e24; }
+            }
+            if (ok23) { ok22 = 1; v22 = mpc_ast_tag(v23, "regex"); } else { e22 = e23; }
+          }
+          if (!ok22) {
+            if (c->bt > 0) { c->pos = p20; c->term = t20; }
+            free(xs20[0]);
+            e20 = e22; break;
+          }
+          xs20[1] = v22;
+          ok20 = 1; v20 = mpcf_state_ast(2, xs20);
+        } while (0);
+      }
+      if (!ok20) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        mpc_ast_delete(xs0[0]);
+        mpc_ast_delete(xs0[1]);
+        e0 = e20; break;
+      }
+      xs0[2] = v20;
+      ok0 = 1; v0 = mpcf_fold_ast(3, xs0);
+    } while (0);
+  }
+  *o = v0;
+  *e = e0;
+  return ok0;
+}
+
+/* expr */
+static int lispy_grammar_parse_22(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth) {
+  int ok0 = 0; mpc_val_t *v0 = NULL; long e0 = -1;
+  if (depth + 0 == c->max) { e0 = c->sup ? -1 : c->pos; } else {
+    int j0 = 0, only0 = 0; long s0 = c->pos;
+    j0 = lispy_grammar_parse_jump2[(unsigned char)c->s[c->pos]];
+    if (j0 != 0 && j0 != 255) { j0--; only0 = 1; } else { j0 = 0; }
+    (void)s0;
+    for (; j0 < 6; j0++) {
+      int ok = 0; mpc_val_t *v = NULL; long e = -1;
+      switch (j0) {
+      case 0: {
+        int ok1 = 0; mpc_val_t *v1 = NULL; long e1 = -1;
+        if (depth + 1 == c->max) { e1 = c->sup ? -1 : c->pos; } else {
+          long p1 = c->pos; int t1 = c->term; mpc_val_t *xs1[2];
+          do {
+            int ok2 = 0; mpc_val_t *v2 = NULL; long e2 = -1;
+            if (depth + 2 == c->max) { e2 = c->sup ? -1 : c->pos; } else {
+              ok2 = 1; v2 = lispy_grammar_parse_state(c);
+            }
+            if (!ok2) {
+              if (c->bt > 0) { c->pos = p1; c->term = t1; }
+              e1 = e2; break;
+            }
+            xs1[0] = v2;
+            int ok3 = 0; mpc_val_t *v3 = NULL; long e3 = -1;
+            if (depth + 2 == c->max) { e3 = c->sup ? -1 : c->pos; } else {
+              int ok4 = 0; mpc_val_t *v4 = NULL; long e4 = -1;
+              if (depth + 3 == c->max) { e4 = c->sup ? -1 : c->pos; } else {
+                int ok5 = 0; mpc_val_t *v5 = NULL; long e5 = -1;
+                ok5 = lispy_grammar_parse_27(c, &v5, &e5, depth + 4);
+                if (ok5) { ok4 = 1; v4 = mpc_ast_add_tag(v5, "number"); } else { e4 = e5; }
+              }
+              if (ok4) { ok3 = 1; v3 = mpc_ast_add_root(v4); } else { e3 = e4; }
+            }
+            if (!ok3) {
+              if (c->bt > 0) { c->pos = p1; c->term = t1; }
+              free(xs1[0]);
+              e1 = e3; break;
+            }
+            xs1[1] = v3;
+            ok1 = 1; v1 = mpcf_state_ast(2, xs1);
+          } while (0);
+        }
+        ok = ok1; v = v1; e = e1;
+        break;
+      }
+      case 1: {
+        int ok6 = 0; mpc_val_t *v6 = NULL; long e6 = -1;
+        if (depth + 1 == c->max) { e6 = c->sup ? -1 : c->pos; } else {
+          long p6 = c->pos; int t6 = c->term; mpc_val_t *xs6[2];
+          do {
+            int ok7 = 0; mpc_val_t *v7 = NULL; long e7 = -1;
+            if (depth + 2 == c->max) { e7 = c->sup ? -1 : c->pos; } else {
+              ok7 = 1; v7 = lispy_grammar_parse_state(c);
+            }
+            if (!ok7) {
+              if (c->bt > 0) { c->pos = p6; c->term = t6; }
+              e6 = e7; break;
+            }
+            xs6[0] = v7;
+            int ok8 = 0; mpc_val_t *v8 = NULL; long e8 = -1;
+            if (depth + 2 == c->max) { e8 = c->sup ? -1 : c->pos; } else {
+              int ok9 = 0; mpc_val_t *v9 = NULL; long e9 = -1;
+              if (depth + 3 == c->max) { e9 = c->sup ? -1 : c->pos; } else {
+                int ok10 = 0; mpc_val_t *v10 = NULL; long e10 = -1;
+                ok10 = lispy_grammar_parse_50(c, &v10, &e10, depth + 4);
+                if (ok10) { ok9 = 1; v9 = mpc_ast_add_tag(v10, "symbol"); } else { e9 = e10; }
+              }
+              if (ok9) { ok8 = 1; v8 = mpc_ast_add_root(v9); } else { e8 = e9; }
+            }
+            if (!ok8) {
+              if (c->bt > 0) { c->pos = p6; c->term = t6; }
+              free(xs6[0]);
+              e6 = e8; break;
+            }
+            xs6[1] = v8;
+            ok6 = 1; v6 = mpcf_state_ast(2, xs6);
+          } while (0);
+        }
+        ok = ok6; v = v6; e = e6;
+        break;
+      }
+      case 2: {
+        int ok11 = 0; mpc_val_t *v11 = NULL; long e11 = -1;
+        if (depth + 1 == c->max) { e11 = c->sup ? -1 : c->pos; } else {
+          long p11 = c->pos; int t11 = c->term; mpc_val_t *xs11[2];
+          do {
+            int ok12 = 0; mpc_val_t *v12 = NULL; long e12 = -1;
+            if (depth + 2 == c->max) { e12 = c->sup ? -1 : c->pos; } else {
+              ok12 = 1; v12 = lispy_grammar_parse_state(c);
+            }
+            if (!ok12) {
+              if (c->bt > 0) { c->pos = p11; c->term = t11; }
+              e11 = e12; break;
+            }
+            xs11[0] = v12;
+            int ok13 = 0; mpc_val_t *v13 = NULL; long e13 = -1;
+            if (depth + 2 == c->max) { e13 = c->sup ? -1 : c->pos; } else {
+              int ok14 = 0; mpc_val_t *v14 = NULL; long e14 = -1;
+              if (depth + 3 == c->max) { e14 = c->sup ? -1 : c->pos; } else {
+                int ok15 = 0; mpc_val_t *v15 = NULL; long e15 = -1;
+                ok15 = lispy_grammar_parse_69(c, &v15, &e15, depth + 4);
+                if (ok15) { ok14 = 1; v14 = mpc_ast_add_tag(v15, "string"); } else { e14 = e15; }
+              }
+              if (ok14) { ok13 = 1; v13 = mpc_ast_add_root(v14); } else { e13 = e14; }
+            }
+            if (!ok13) {
+              if (c->bt > 0) { c->pos = p11; c->term = t11; }
+              free(xs11[0]);
+              e11 = e13; break;
+            }
+            xs11[1] = v13;
+            ok11 = 1; v11 = mpcf_state_ast(2, xs11);
+          } while (0);
+        }
+        ok = ok11; v = v11; e = e11;
+        break;
+      }
+      case 3: {
+        int ok16 = 0; mpc_val_t *v16 = NULL; long e16 = -1;
+        if (depth + 1 == c->max) { e16 = c->sup ? -1 : c->pos; } else {
+          long p16 = c->pos; int t16 = c->term; mpc_val_t *xs16[2];
+          do {
+            int ok17 = 0; mpc_val_t *v17 = NULL; long e17 = -1;
+            if (depth + 2 == c->max) { e17 = c->sup ? -1 : c->pos; } else {
+              ok17 = 1; v17 = lispy_grammar_parse_state(c);
+            }
+            if (!ok17) {
+              if (c->bt > 0) { c->pos = p16; c->term = t16; }
+              e16 = e17; break;
+            }
+            xs16[0] = v17;
+            int ok18 = 0; mpc_val_t *v18 = NULL; long e18 = -1;
+            if (depth + 2 == c->max) { e18 = c->sup ? -1 : c->pos; } else {
+              int ok19 = 0; mpc_val_t *v19 = NULL; long e19 = -1;
+              if (depth + 3 == c->max) { e19 = c->sup ? -1 : c->pos; } else {
+                int ok20 = 0; mpc_val_t *v20 = NULL; long e20 = -1;
+                ok20 = lispy_grammar_parse_100(c, &v20, &e20, depth + 4);
+                if (ok20) { ok19 = 1; v19 = mpc_ast_add_tag(v20, "comment"); } else { e19 = e20; }
+              }
+              if (ok19) { ok18 = 1; v18 = mpc_ast_add_root(v19); } else { e18 = e19; }
+            }
+            if (!ok18) {
+              if (c->bt > 0) { c->pos = p16; c->term = t16; }
+              free(xs16[0]);
+              e16 = e18; break;
+            }
+            xs16[1] = v18;
+            ok16 = 1; v16 = mpcf_state_ast(2, xs16);
+          } while (0);
+        }
+        ok = ok16; v = v16; e = e16;
+        break;
+      }
+      case 4: {
+        int ok21 = 0; mpc_val_t *v21 = NULL; long e21 = -1;
+        if (depth + 1 == c->max) { e21 = c->sup ? -1 : c->pos; } else {
+          long p21 = c->pos; int t21 = c->term; mpc_val_t *xs21[2];
+          do {
+            int ok22 = 0; mpc_val_t *v22 = NULL; long e22 = -1;
+            if (depth + 2 == c->max) { e22 = c->sup ? -1 : c->pos; } else {
+              ok22 = 1; v22 = lispy_grammar_parse_state(c);
+            }
+            if (!ok22) {
+              if (c->bt > 0) { c->pos = p21; c->term = t21; }
+              e21 = e22; break;
+            }
+            xs21[0] = v22;
+            int ok23 = 0; mpc_val_t *v23 = NULL; long e23 = -1;
+            if (depth + 2 == c->max) { e23 = c->sup ? -1 : c->pos; } else {
+              int ok24 = 0; mpc_val_t *v24 = NULL; long e24 = -1;
+              if (depth + 3 == c->max) { e24 = c->sup ? -1 : c->pos; } else {
+                int ok25 = 0; mpc_val_t *v25 = NULL; long e25 = -1;
+                ok25 = lispy_grammar_parse_122(c, &v25, &e25, depth + 4);
+                if (ok25) { ok24 = 1; v24 = mpc_ast_add_tag(v25, "sexpr"); } else { e24 = e25; }
+              }
+              if (ok24) { ok23 = 1; v23 = mpc_ast_add_root(v24); } else { e23 = e24; }
+            }
+            if (!ok23) {
+              if (c->bt > 0) { c->pos = p21; c->term = t21; }
+              free(xs21[0]);
+              e21 = e23; break;
+            }
+            xs21[1] = v23;
+            ok21 = 1; v21 = mpcf_state_ast(2, xs21);
+          } while (0);
+        }
+        ok = ok21; v = v21; e = e21;
+        break;
+      }
+      case 5: {
+        int ok26 = 0; mpc_val_t *v26 = NULL; long e26 = -1;
+        if (depth + 1 == c->max) { e26 = c->sup ? -1 : c->pos; } else {
+          long p26 = c->pos; int t26 = c->term; mpc_val_t *xs26[2];
+          do {
+            int ok27 = 0; mpc_val_t *v27 = NULL; long e27 = -1;
+            if (depth + 2 == c->max) { e27 = c->sup ? -1 : c->pos; } else {
+              ok27 = 1; v27 = lispy_grammar_parse_state(c);
+            }
+            if (!ok27) {
+              if (c->bt > 0) { c->pos = p26; c->term = t26; }
+              e26 = e27; break;
+            }
+            xs26[0] = v27;
+            int ok28 = 0; mpc_val_t *v28 = NULL; long e28 = -1;
+            if (depth + 2 == c->max) { e28 = c->sup ? -1 : c->pos; } else {
+              int ok29 = 0; mpc_val_t *v29 = NULL; long e29 = -1;
+              if (depth + 3 == c->max) { e29 = c->sup ? -1 : c->pos; } else {
+                int ok30 = 0; mpc_val_t *v30 = NULL; long e30 = -1;
+                ok30 = lispy_grammar_parse_160(c, &v30, &e30, depth + 4);
+                if (ok30) { ok29 = 1; v29 = mpc_ast_add_tag(v30, "qexpr"); } else { e29 = e30; }
+              }
+              if (ok29) { ok28 = 1; v28 = mpc_ast_add_root(v29); } else { e28 = e29; }
+            }
+            if (!ok28) {
+              if (c->bt > 0) { c->pos = p26; c->term = t26; }
+              free(xs26[0]);
+              e26 = e28; break;
+            }
+            xs26[1] = v28;
+            ok26 = 1; v26 = mpcf_state_ast(2, xs26);
+          } while (0);
+        }
+        ok = ok26; v = v26; e = e26;
+        break;
+      }
+      }
+      if (ok) { ok0 = 1; v0 = v; break; }
+      if (only0) { if (e > s0) { break; } only0 = 0; j0 = -1; }
+    }
+  }
+  *o = v0;
+  *e = e0;
+  return ok0;
+}
+
+/* number */
+static int lispy_grammar_parse_27(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth) {
+  int ok0 = 0; mpc_val_t *v0 = NULL; long e0 = -1;
+  if (depth + 0 == c->max) { e0 = c->sup ? -1 : c->pos; } else {
+    long p0 = c->pos; int t0 = c->term; mpc_val_t *xs0[2];
+    do {
+      int ok1 = 0; mpc_val_t *v1 = NULL; long e1 = -1;
+      if (depth + 1 == c->max) { e1 = c->sup ? -1 : c->pos; } else {
+        ok1 = 1; v1 = lispy_grammar_parse_state(c);
+      }
+      if (!ok1) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        e0 = e1; break;
+      }
+      xs0[0] = v1;
+      int ok2 = 0; mpc_val_t *v2 = NULL; long e2 = -1;
+      if (depth + 1 == c->max) { e2 = c->sup ? -1 : c->pos; } else {
+        int ok3 = 0; mpc_val_t *v3 = NULL; long e3 = -1;
+        if (depth + 2 == c->max) { e3 = c->sup ? -1 : c->pos; } else {
+          int ok4 = 0; mpc_val_t *v4 = NULL; long e4 = -1;
+          if (depth + 3 == c->max) { e4 = c->sup ? -1 : c->pos; } else {
+            long p4 = c->pos; int t4 = c->term; mpc_val_t *xs4[2];
+            do {
+              int ok5 = 0; mpc_val_t *v5 = NULL; long e5 = -1;
+              if (depth + 4 == c->max) { e5 = c->sup ? -1 : c->pos; } else {
+                long p5 = c->pos; int t5 = c->term; mpc_val_t *xs5[2];
+                do {
+                  int ok6 = 0; mpc_val_t *v6 = NULL; long e6 = -1;
+                  if (depth + 5 == c->max) { e6 = c->sup ? -1 : c->pos; } else {
+                    int ok7 = 0; mpc_val_t *v7 = NULL; long e7 = -1;
+                    if (depth + 6 == c->max) { e7 = c->sup ? -1 : c->pos; } else {
+                      c->sup++;
+                      int ok8 = 0; mpc_val_t *v8 = NULL; long e8 = -1;
+                      if (depth + 7 == c->max) { e8 = c->sup ? -1 : c->pos; } else {
+                        if (c->s[c->pos] == '-') { ok8 = 1; v8 = lispy_grammar_parse_chr(c); }
+                      }
+                      c->sup--; (void)e8;
+                      if (ok8) { ok7 = 1; v7 = v8; } else { e7 = c->sup ? -1 : c->pos; }
+                    }
+                    (void)e7;
+                    ok6 = 1; v6 = ok7 ? v7 : mpcf_ctor_str();
+                  }
+                  if (!ok6) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    e5 = e6; break;
+                  }
+                  xs5[0] = v6;
+                  int ok9 = 0; mpc_val_t *v9 = NULL; long e9 = -1;
+                  if (depth + 5 == c->max) { e9 = c->sup ? -1 : c->pos; } else {
+                    char *b9 = NULL; size_t l9 = 0, m9 = 0; long j9 = 0, q9;
+                    for (;;) {
+                      for (q9 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set3, c->s[c->pos]); c->pos++);
+                      lispy_grammar_parse_cat(&b9, &l9, &m9, c->s + q9, c->pos - q9); j9 += c->pos - q9;
+                      e9 = c->sup ? -1 : c->pos;
+                      break;
+                    }
+                    if (j9 >= 1) { ok9 = 1; v9 = b9; e9 = -1; } else { free(b9); }
+                  }
+                  if (!ok9) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    free(xs5[0]);
+                    e5 = e9; break;
+                  }
+                  xs5[1] = v9;
+                  ok5 = 1; v5 = mpcf_strfold(2, xs5);
+                } while (0);
+              }
+              if (!ok5) {
+                if (c->bt > 0) { c->pos = p4; c->term = t4; }
+                e4 = e5; break;
+              }
+              xs4[0] = v5;
+              int ok10 = 0; mpc_val_t *v10 = NULL; long e10 = -1;
+              if (depth + 4 == c->max) { e10 = c->sup ? -1 : c->pos; } else {
+                c->sup++;
+                int ok11 = 0; mpc_val_t *v11 = NULL; long e11 = -1;
+                if (depth + 5 == c->max) { e11 = c->sup ? -1 : c->pos; } else {
+                  int ok12 = 0; mpc_val_t *v12 = NULL; long e12 = -1;
+                  if (depth + 6 == c->max) { e12 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok13 = 0; mpc_val_t *v13 = NULL; long e13 = -1;
+                    if (depth + 7 == c->max) { e13 = c->sup ? -1 : c->pos; } else {
+                      char *b13 = NULL; size_t l13 = 0, m13 = 0; long j13 = 0, q13;
+                      for (;;) {
+                        for (q13 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set4, c->s[c->pos]); c->pos++);
+                        lispy_grammar_parse_cat(&b13, &l13, &m13, c->s + q13, c->pos - q13); j13 += c->pos - q13;
+                        e13 = c->sup ? -1 : c->pos;
+                        break;
+                      }
+                      if (j13 >= 0) { ok13 = 1; v13 = b13; e13 = -1; } else { free(b13); }
+                    }
+                    c->sup--; (void)e13;
+                    if (ok13) { ok12 = 1; v12 = v13; } else { e12 = c->sup ? -1 : c->pos; }
+                  }
+                  if (ok12) { ok11 = 1; v11 = mpcf_free(v12); } else { e11 = e12; }
+                }
+                c->sup--; (void)e11;
+                if (ok11) { ok10 = 1; v10 = v11; } else { e10 = c->sup ? -1 : c->pos; }
+              }
+              if (!ok10) {
+                if (c->bt > 0) { c->pos = p4; c->term = t4; }
+                mpcf_dtor_null(xs4[0]);
+                e4 = e10; break;
+              }
+              xs4[1] = v10;
+              ok4 = 1; v4 = mpcf_fst(2, xs4);
+            } while (0);
+          }
+          if (ok4) { ok3 = 1; v3 = lispy_grammar_parse_str_ast(c, v4); } else { e3 = e4; }
+        }
+        if (ok3) { ok2 = 1; v2 = mpc_ast_tag(v3, "regex"); } else { e2 = e3; }
+      }
+      if (!ok2) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        free(xs0[0]);
+        e0 = e2; break;
+      }
+      xs0[1] = v2;
+      ok0 = 1; v0 = mpcf_state_ast(2, xs0);
+    } while (0);
+  }
+  *o = v0;
+  *e = e0;
+  return ok0;
+}
+
+/* symbol */
+static int lispy_grammar_parse_50(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth) {
+  int ok0 = 0; mpc_val_t *v0 = NULL; long e0 = -1;
+  if (depth + 0 == c->max) { e0 = c->sup ? -1 : c->pos; } else {
+    long p0 = c->pos; int t0 = c->term; mpc_val_t *xs0[2];
+    do {
+      int ok1 = 0; mpc_val_t *v1 = NULL; long e1 = -1;
+      if (depth + 1 == c->max) { e1 = c->sup ? -1 : c->pos; } else {
+        ok1 = 1; v1 = lispy_grammar_parse_state(c);
+      }
+      if (!ok1) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        e0 = e1; break;
+      }
+      xs0[0] = v1;
+      int ok2 = 0; mpc_val_t *v2 = NULL; long e2 = -1;
+      if (depth + 1 == c->max) { e2 = c->sup ? -1 : c->pos; } else {
+        int ok3 = 0; mpc_val_t *v3 = NULL; long e3 = -1;
+        if (depth + 2 == c->max) { e3 = c->sup ? -1 : c->pos; } else {
+          int ok4 = 0; mpc_val_t *v4 = NULL; long e4 = -1;
+          if (depth + 3 == c->max) { e4 = c->sup ? -1 : c->pos; } else {
+            long p4 = c->pos; int t4 = c->term; mpc_val_t *xs4[2];
+            do {
+              int ok5 = 0; mpc_val_t *v5 = NULL; long e5 = -1;
+              if (depth + 4 == c->max) { e5 = c->sup ? -1 : c->pos; } else {
+                char *b5 = NULL; size_t l5 = 0, m5 = 0; long j5 = 0, q5;
+                for (;;) {
+                  for (q5 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set5, c->s[c->pos]); c->pos++);
+                  lispy_grammar_parse_cat(&b5, &l5, &m5, c->s + q5, c->pos - q5); j5 += c->pos - q5;
+                  e5 = c->sup ? -1 : c->pos;
+                  break;
+                }
+                if (j5 >= 1) { ok5 = 1; v5 = b5; e5 = -1; } else { free(b5); }
+              }
+              if (!ok5) {
+                if (c->bt > 0) { c->pos = p4; c->term = t4; }
+                e4 = e5; break;
+              }
+              xs4[0] = v5;
+              int ok6 = 0; mpc_val_t *v6 = NULL; long e6 = -1;
+              if (depth + 4 == c->max) { e6 = c->sup ? -1 : c->pos; } else {
+                c->sup++;
+                int ok7 = 0; mpc_val_t *v7 = NULL; long e7 = -1;
+                if (depth + 5 == c->max) { e7 = c->sup ? -1 : c->pos; } else {
+                  int ok8 = 0; mpc_val_t *v8 = NULL; long e8 = -1;
+                  if (depth + 6 == c->max) { e8 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok9 = 0; mpc_val_t *v9 = NULL; long e9 = -1;
+                    if (depth + 7 == c->max) { e9 = c->sup ? -1 : c->pos; } else {
+                      char *b9 = NULL; size_t l9 = 0, m9 = 0; long j9 = 0, q9;
+                      for (;;) {
+                        for (q9 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set6, c->s[c->pos]); c->pos++);
+                        lispy_grammar_parse_cat(&b9, &l9, &m9, c->s + q9, c->pos - q9); j9 += c->pos - q9;
+                        e9 = c->sup ? -1 : c->pos;
+                        break;
+                      }
+                      if (j9 >= 0) { ok9 = 1; v9 = b9; e9 = -1; } else { free(b9); }
+                    }
+                    c->sup--; (void)e9;
+                    if (ok9) { ok8 = 1; v8 = v9; } else { e8 = c->sup ? -1 : c->pos; }
+                  }
+                  if (ok8) { ok7 = 1; v7 = mpcf_free(v8); } else { e7 = e8; }
+                }
+                c->sup--; (void)e7;
+                if (ok7) { ok6 = 1; v6 = v7; } else { e6 = c->sup ? -1 : c->pos; }
+              }
+              if (!ok6) {
+                if (c->bt > 0) { c->pos = p4; c->term = t4; }
+                mpcf_dtor_null(xs4[0]);
+                e4 = e6; break;
+              }
+              xs4[1] = v6;
+              ok4 = 1; v4 = mpcf_fst(2, xs4);
+            } while (0);
+          }
+          if (ok4) { ok3 = 1; v3 = lispy_grammar_parse_str_ast(c, v4); } else { e3 = e4; }
+        }
+        if (ok3) { ok2 = 1; v2 = mpc_ast_tag(v3, "regex"); } else { e2 = e3; }
+      }
+      if (!ok2) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        free(xs0[0]);
+        e0 = e2; break;
+      }
+      xs0[1] = v2;
+      ok0 = 1; v0 = mpcf_state_ast(2, xs0);
+    } while (0);
+  }
+  *o = v0;
+  *e = e0;
+  return ok0;
+}
+
+/* string */
+static int lispy_grammar_parse_69(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth) {
+  int ok0 = 0; mpc_val_t *v0 = NULL; long e0 = -1;
+  if (depth + 0 == c->max) { e0 = c->sup ? -1 : c->pos; } else {
+    long p0 = c->pos; int t0 = c->term; mpc_val_t *xs0[2];
+    do {
+      int ok1 = 0; mpc_val_t *v1 = NULL; long e1 = -1;
+      if (depth + 1 == c->max) { e1 = c->sup ? -1 : c->pos; } else {
+        ok1 = 1; v1 = lispy_grammar_parse_state(c);
+      }
+      if (!ok1) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        e0 = e1; break;
+      }
+      xs0[0] = v1;
+      int ok2 = 0; mpc_val_t *v2 = NULL; long e2 = -1;
+      if (depth + 1 == c->max) { e2 = c->sup ? -1 : c->pos; } else {
+        int ok3 = 0; mpc_val_t *v3 = NULL; long e3 = -1;
+        if (depth + 2 == c->max) { e3 = c->sup ? -1 : c->pos; } else {
+          int ok4 = 0; mpc_val_t *v4 = NULL; long e4 = -1;
+          if (depth + 3 == c->max) { e4 = c->sup ? -1 : c->pos; } else {
+            long p4 = c->pos; int t4 = c->term; mpc_val_t *xs4[2];
+            do {
+              int ok5 = 0; mpc_val_t *v5 = NULL; long e5 = -1;
+              if (depth + 4 == c->max) { e5 = c->sup ? -1 : c->pos; } else {
+                long p5 = c->pos; int t5 = c->term; mpc_val_t *xs5[3];
+                do {
+                  int ok6 = 0; mpc_val_t *v6 = NULL; long e6 = -1;
+                  if (depth + 5 == c->max) { e6 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok7 = 0; mpc_val_t *v7 = NULL; long e7 = -1;
+                    if (depth + 6 == c->max) { e7 = c->sup ? -1 : c->pos; } else {
+                      if (c->s[c->pos] == '"') { ok7 = 1; v7 = lispy_grammar_parse_chr(c); }
+                    }
+                    c->sup--; (void)e7;
+                    if (ok7) { ok6 = 1; v6 = v7; } else { e6 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok6) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    e5 = e6; break;
+                  }
+                  xs5[0] = v6;
+                  int ok8 = 0; mpc_val_t *v8 = NULL; long e8 = -1;
+                  if (depth + 5 == c->max) { e8 = c->sup ? -1 : c->pos; } else {
+                    char *b8 = NULL; size_t l8 = 0, m8 = 0; long j8 = 0, q8;
+                    for (;;) {
+                      for (q8 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set7, c->s[c->pos]); c->pos++);
+                      lispy_grammar_parse_cat(&b8, &l8, &m8, c->s + q8, c->pos - q8); j8 += c->pos - q8;
+                      int ok9 = 0; mpc_val_t *v9 = NULL; long e9 = -1;
+                      if (depth + 6 == c->max) { e9 = c->sup ? -1 : c->pos; } else {
+                        int j9 = 0, only9 = 0; long s9 = c->pos;
+                        j9 = lispy_grammar_parse_jump8[(unsigned char)c->s[c->pos]];
+                        if (j9 != 0 && j9 != 255) { j9--; only9 = 1; } else { j9 = 0; }
+                        (void)s9;
+                        for (; j9 < 2; j9++) {
+                          int ok = 0; mpc_val_t *v = NULL; long e = -1;
+                          switch (j9) {
+                          case 0: {
+                            int ok10 = 0; mpc_val_t *v10 = NULL; long e10 = -1;
+                            if (depth + 7 == c->max) { e10 = c->sup ? -1 : c->pos; } else {
+                              long p10 = c->pos; int t10 = c->term; mpc_val_t *xs10[2];
+                              do {
+                                int ok11 = 0; mpc_val_t *v11 = NULL; long e11 = -1;
+                                if (depth + 8 == c->max) { e11 = c->sup ? -1 : c->pos; } else {
+                                  c->sup++;
+                                  int ok12 = 0; mpc_val_t *v12 = NULL; long e12 = -1;
+                                  if (depth + 9 == c->max) { e12 = c->sup ? -1 : c->pos; } else {
+                                    if (c->s[c->pos] == '\134') { ok12 = 1; v12 = lispy_grammar_parse_chr(c); }
+                                  }
+                                  c->sup--; (void)e12;
+                                  if (ok12) { ok11 = 1; v11 = v12; } else { e11 = c->sup ? -1 : c->pos; }
+                                }
+                                if (!ok11) {
+                                  if (c->bt > 0) { c->pos = p10; c->term = t10; }
+                                  e10 = e11; break;
+                                }
+                                xs10[0] = v11;
+                                int ok13 = 0; mpc_val_t *v13 = NULL; long e13 = -1;
+                                if (depth + 8 == c->max) { e13 = c->sup ? -1 : c->pos; } else {
+                                  c->sup++;
+                                  int ok14 = 0; mpc_val_t *v14 = NULL; long e14 = -1;
+                                  if (depth + 9 == c->max) { e14 = c->sup ? -1 : c->pos; } else {
+                                    c->sup++;
+                                    int ok15 = 0; mpc_val_t *v15 = NULL; long e15 = -1;
+                                    if (depth + 10 == c->max) { e15 = c->sup ? -1 : c->pos; } else {
+                                      if (lispy_grammar_parse_in(lispy_grammar_parse_set9, c->s[c->pos])) { ok15 = 1; v15 = lispy_grammar_parse_chr(c); }
+                                    }
+                                    c->sup--; (void)e15;
+                                    if (ok15) { ok14 = 1; v14 = v15; } else { e14 = c->sup ? -1 : c->pos; }
+                                  }
+                                  c->sup--; (void)e14;
+                                  if (ok14) { ok13 = 1; v13 = v14; } else { e13 = c->sup ? -1 : c->pos; }
+                                }
+                                if (!ok13) {
+                                  if (c->bt > 0) { c->pos = p10; c->term = t10; }
+                                  free(xs10[0]);
+                                  e10 = e13; break;
+                                }
+                                xs10[1] = v13;
+                                ok10 = 1; v10 = mpcf_strfold(2, xs10);
+                              } while (0);
+                            }
+                            ok = ok10; v = v10; e = e10;
+                            break;
+                          }
+                          case 1: {
+                            int ok16 = 0; mpc_val_t *v16 = NULL; long e16 = -1;
+                            if (depth + 7 == c->max) { e16 = c->sup ? -1 : c->pos; } else {
+                              c->sup++;
+                              int ok17 = 0; mpc_val_t *v17 = NULL; long e17 = -1;
+                              if (depth + 8 == c->max) { e17 = c->sup ? -1 : c->pos; } else {
+                                if (lispy_grammar_parse_in(lispy_grammar_parse_set10, c->s[c->pos])) { ok17 = 1; v17 = lispy_grammar_parse_chr(c); }
+                              }
+                              c->sup--; (void)e17;
+                              if (ok17) { ok16 = 1; v16 = v17; } else { e16 = c->sup ? -1 : c->pos; }
+                            }
+                            ok = ok16; v = v16; e = e16;
+                            break;
+                          }
+                          }
+                          if (ok) { ok9 = 1; v9 = v; break; }
+                          if (only9) { if (e > s9) { break; } only9 = 0; j9 = -1; }
+                        }
+                      }
+                      if (!ok9) { e8 = e9; break; }
+                      lispy_grammar_parse_cat(&b8, &l8, &m8, v9, strlen(v9)); free(v9); j8++;
+                    }
+                    if (j8 >= 0) { ok8 = 1; v8 = b8; e8 = -1; } else { free(b8); }
+                  }
+                  if (!ok8) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    free(xs5[0]);
+                    e5 = e8; break;
+                  }
+                  xs5[1] = v8;
+                  int ok18 = 0; mpc_val_t *v18 = NULL; long e18 = -1;
+                  if (depth + 5 == c->max) { e18 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok19 = 0; mpc_val_t *v19 = NULL; long e19 = -1;
+                    if (depth + 6 == c->max) { e19 = c->sup ? -1 : c->pos; } else {
+                      if (c->s[c->pos] == '"') { ok19 = 1; v19 = lispy_grammar_parse_chr(c); }
+                    }
+                    c->sup--; (void)e19;
+                    if (ok19) { ok18 = 1; v18 = v19; } else { e18 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok18) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    free(xs5[0]);
+                    free(xs5[1]);
+                    e5 = e18; break;
+                  }
+                  xs5[2] = v18;
+                  ok5 = 1; v5 = mpcf_strfold(3, xs5);
+                } while (0);
+              }
+              if (!ok5) {
+                if (c->bt > 0) { c->pos = p4; c->term = t4; }
+                e4 = e5; break;
+              }
+              xs4[0] = v5;
+              int ok20 = 0; mpc_val_t *v20 = NULL; long e20 = -1;
+              if (depth + 4 == c->max) { e20 = c->sup ? -1 : c->pos; } else {
+                c->sup++;
+                int ok21 = 0; mpc_val_t *v21 = NULL; long e21 = -1;
+                if (depth + 5 == c->max) { e21 = c->sup ? -1 : c->pos; } else {
+                  int ok22 = 0; mpc_val_t *v22 = NULL; long e22 = -1;
+                  if (depth + 6 == c->max) { e22 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok23 = 0; mpc_val_t *v23 = NULL; long e23 = -1;
+                    if (depth + 7 == c->max) { e23 = c->sup ? -1 : c->pos; } else {
+                      char *b23 = NULL; size_t l23 = 0, m23 = 0; long j23 = 0, q23;
+                      for (;;) {
+                        for (q23 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set11, c->s[c->pos]); c->pos++);
+                        lispy_grammar_parse_cat(&b23, &l23, &m23, c->s + q23, c->pos - q23); j23 += c->pos - q23;
+                        e23 = c->sup ? -1 : c->pos;
+                        break;
+                      }
+                      if (j23 >= 0) { ok23 = 1; v23 = b23; e23 = -1; } else { free(b23); }
+                    }
+                    c->sup--; (void)e23;
+                    if (ok23) { ok22 = 1; v22 = v23; } else { e22 = c->sup ? -1 : c->pos; }
+                  }
+                  if (ok22) { ok21 = 1; v21 = mpcf_free(v22); } else { e21 = e22; }
+                }
+                c->sup--; (void)e21;
+                if (ok21) { ok20 = 1; v20 = v21; } else { e20 = c->sup ? -1 : c->pos; }
+              }
+              if (!ok20) {
+                if (c->bt > 0) { c->pos = p4; c->term = t4; }
+                mpcf_dtor_null(xs4[0]);
+                e4 = e20; break;
+              }
+              xs4[1] = v20;
+              ok4 = 1; v4 = mpcf_fst(2, xs4);
+            } while (0);
+          }
+          if (ok4) { ok3 = 1; v3 = lispy_grammar_parse_str_ast(c, v4); } else { e3 = e4; }
+        }
+        if (ok3) { ok2 = 1; v2 = mpc_ast_tag(v3, "regex"); } else { e2 = e3; }
+      }
+      if (!ok2) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        free(xs0[0]);
+        e0 = e2; break;
+      }
+      xs0[1] = v2;
+      ok0 = 1; v0 = mpcf_state_ast(2, xs0);
+    } while (0);
+  }
+  *o = v0;
+  *e = e0;
+  return ok0;
+}
+
+/* comment */
+static int lispy_grammar_parse_100(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth) {
+  int ok0 = 0; mpc_val_t *v0 = NULL; long e0 = -1;
+  if (depth + 0 == c->max) { e0 = c->sup ? -1 : c->pos; } else {
+    long p0 = c->pos; int t0 = c->term; mpc_val_t *xs0[2];
+    do {
+      int ok1 = 0; mpc_val_t *v1 = NULL; long e1 = -1;
+      if (depth + 1 == c->max) { e1 = c->sup ? -1 : c->pos; } else {
+        ok1 = 1; v1 = lispy_grammar_parse_state(c);
+      }
+      if (!ok1) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        e0 = e1; break;
+      }
+      xs0[0] = v1;
+      int ok2 = 0; mpc_val_t *v2 = NULL; long e2 = -1;
+      if (depth + 1 == c->max) { e2 = c->sup ? -1 : c->pos; } else {
+        int ok3 = 0; mpc_val_t *v3 = NULL; long e3 = -1;
+        if (depth + 2 == c->max) { e3 = c->sup ? -1 : c->pos; } else {
+          int ok4 = 0; mpc_val_t *v4 = NULL; long e4 = -1;
+          if (depth + 3 == c->max) { e4 = c->sup ? -1 : c->pos; } else {
+            long p4 = c->pos; int t4 = c->term; mpc_val_t *xs4[2];
+            do {
+              int ok5 = 0; mpc_val_t *v5 = NULL; long e5 = -1;
+              if (depth + 4 == c->max) { e5 = c->sup ? -1 : c->pos; } else {
+                long p5 = c->pos; int t5 = c->term; mpc_val_t *xs5[2];
+                do {
+                  int ok6 = 0; mpc_val_t *v6 = NULL; long e6 = -1;
+                  if (depth + 5 == c->max) { e6 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok7 = 0; mpc_val_t *v7 = NULL; long e7 = -1;
+                    if (depth + 6 == c->max) { e7 = c->sup ? -1 : c->pos; } else {
+                      if (c->s[c->pos] == ';') { ok7 = 1; v7 = lispy_grammar_parse_chr(c); }
+                    }
+                    c->sup--; (void)e7;
+                    if (ok7) { ok6 = 1; v6 = v7; } else { e6 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok6) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    e5 = e6; break;
+                  }
+                  xs5[0] = v6;
+                  int ok8 = 0; mpc_val_t *v8 = NULL; long e8 = -1;
+                  if (depth + 5 == c->max) { e8 = c->sup ? -1 : c->pos; } else {
+                    char *b8 = NULL; size_t l8 = 0, m8 = 0; long j8 = 0, q8;
+                    for (;;) {
+                      for (q8 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set12, c->s[c->pos]); c->pos++);
+                      lispy_grammar_parse_cat(&b8, &l8, &m8, c->s + q8, c->pos - q8); j8 += c->pos - q8;
+                      e8 = c->sup ? -1 : c->pos;
+                      break;
+                    }
+                    if (j8 >= 0) { ok8 = 1; v8 = b8; e8 = -1; } else { free(b8); }
+                  }
+                  if (!ok8) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    free(xs5[0]);
+                    e5 = e8; break;
+                  }
+                  xs5[1] = v8;
+                  ok5 = 1; v5 = mpcf_strfold(2, xs5);
+                } while (0);
+              }
+              if (!ok5) {
+                if (c->bt > 0) { c->pos = p4; c->term = t4; }
+                e4 = e5; break;
+              }
+              xs4[0] = v5;
+              int ok9 = 0; mpc_val_t *v9 = NULL; long e9 = -1;
+              if (depth + 4 == c->max) { e9 = c->sup ? -1 : c->pos; } else {
+                c->sup++;
+                int ok10 = 0; mpc_val_t *v10 = NULL; long e10 = -1;
+                if (depth + 5 == c->max) { e10 = c->sup ? -1 : c->pos; } else {
+                  int ok11 = 0; mpc_val_t *v11 = NULL; long e11 = -1;
+                  if (depth + 6 == c->max) { e11 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok12 = 0; mpc_val_t *v12 = NULL; long e12 = -1;
+                    if (depth + 7 == c->max) { e12 = c->sup ? -1 : c->pos; } else {
+                      char *b12 = NULL; size_t l12 = 0, m12 = 0; long j12 = 0, q12;
+                      for (;;) {
+                        for (q12 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set13, c->s[c->pos]); c->pos++);
+                        lispy_grammar_parse_cat(&b12, &l12, &m12, c->s + q12, c->pos - q12); j12 += c->pos - q12;
+                        e12 = c->sup ? -1 : c->pos;
+                        break;
+                      }
+                      if (j12 >= 0) { ok12 = 1; v12 = b12; e12 = -1; } else { free(b12); }
+                    }
+                    c->sup--; (void)e12;
+                    if (ok12) { ok11 = 1; v11 = v12; } else { e11 = c->sup ? -1 : c->pos; }
+                  }
+                  if (ok11) { ok10 = 1; v10 = mpcf_free(v11); } else { e10 = e11; }
+                }
+                c->sup--; (void)e10;
+                if (ok10) { ok9 = 1; v9 = v10; } else { e9 = c->sup ? -1 : c->pos; }
+              }
+              if (!ok9) {
+                if (c->bt > 0) { c->pos = p4; c->term = t4; }
+                mpcf_dtor_null(xs4[0]);
+                e4 = e9; break;
+              }
+              xs4[1] = v9;
+              ok4 = 1; v4 = mpcf_fst(2, xs4);
+            } while (0);
+          }
+          if (ok4) { ok3 = 1; v3 = lispy_grammar_parse_str_ast(c, v4); } else { e3 = e4; }
+        }
+        if (ok3) { ok2 = 1; v2 = mpc_ast_tag(v3, "regex"); } else { e2 = e3; }
+      }
+      if (!ok2) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        free(xs0[0]);
+        e0 = e2; break;
+      }
+      xs0[1] = v2;
+      ok0 = 1; v0 = mpcf_state_ast(2, xs0);
+    } while (0);
+  }
+  *o = v0;
+  *e = e0;
+  return ok0;
+}
+
+/* sexpr */
+static int lispy_grammar_parse_122(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth) {
+  int ok0 = 0; mpc_val_t *v0 = NULL; long e0 = -1;
+  if (depth + 0 == c->max) { e0 = c->sup ? -1 : c->pos; } else {
+    long p0 = c->pos; int t0 = c->term; mpc_val_t *xs0[3];
+    do {
+      int ok1 = 0; mpc_val_t *v1 = NULL; long e1 = -1;
+      if (depth + 1 == c->max) { e1 = c->sup ? -1 : c->pos; } else {
+        long p1 = c->pos; int t1 = c->term; mpc_val_t *xs1[2];
+        do {
+          int ok2 = 0; mpc_val_t *v2 = NULL; long e2 = -1;
+          if (depth + 2 == c->max) { e2 = c->sup ? -1 : c->pos; } else {
+            ok2 = 1; v2 = lispy_grammar_parse_state(c);
+          }
+          if (!ok2) {
+            if (c->bt > 0) { c->pos = p1; c->term = t1; }
+            e1 = e2; break;
+          }
+          xs1[0] = v2;
+          int ok3 = 0; mpc_val_t *v3 = NULL; long e3 = -1;
+          if (depth + 2 == c->max) { e3 = c->sup ? -1 : c->pos; } else {
+            int ok4 = 0; mpc_val_t *v4 = NULL; long e4 = -1;
+            if (depth + 3 == c->max) { e4 = c->sup ? -1 : c->pos; } else {
+              int ok5 = 0; mpc_val_t *v5 = NULL; long e5 = -1;
+              if (depth + 4 == c->max) { e5 = c->sup ? -1 : c->pos; } else {
+                long p5 = c->pos; int t5 = c->term; mpc_val_t *xs5[2];
+                do {
+                  int ok6 = 0; mpc_val_t *v6 = NULL; long e6 = -1;
+                  if (depth + 5 == c->max) { e6 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok7 = 0; mpc_val_t *v7 = NULL; long e7 = -1;
+                    if (depth + 6 == c->max) { e7 = c->sup ? -1 : c->pos; } else {
+                      if (c->s[c->pos] == '(') { ok7 = 1; v7 = lispy_grammar_parse_chr(c); }
+                    }
+                    c->sup--; (void)e7;
+                    if (ok7) { ok6 = 1; v6 = v7; } else { e6 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok6) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    e5 = e6; break;
+                  }
+                  xs5[0] = v6;
+                  int ok8 = 0; mpc_val_t *v8 = NULL; long e8 = -1;
+                  if (depth + 5 == c->max) { e8 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok9 = 0; mpc_val_t *v9 = NULL; long e9 = -1;
+                    if (depth + 6 == c->max) { e9 = c->sup ? -1 : c->pos; } else {
+                      int ok10 = 0; mpc_val_t *v10 = NULL; long e10 = -1;
+                      if (depth + 7 == c->max) { e10 = c->sup ? -1 : c->pos; } else {
+                        c->sup++;
+                        int ok11 = 0; mpc_val_t *v11 = NULL; long e11 = -1;
+                        if (depth + 8 == c->max) { e11 = c->sup ? -1 : c->pos; } else {
+                          char *b11 = NULL; size_t l11 = 0, m11 = 0; long j11 = 0, q11;
+                          for (;;) {
+                            for (q11 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set14, c->s[c->pos]); c->pos++);
+                            lispy_grammar_parse_cat(&b11, &l11, &m11, c->s + q11, c->pos - q11); j11 += c->pos - q11;
+                            e11 = c->sup ? -1 : c->pos;
+                            break;
+                          }
+                          if (j11 >= 0) { ok11 = 1; v11 = b11; e11 = -1; } else { free(b11); }
+                        }
+                        c->sup--; (void)e11;
+                        if (ok11) { ok10 = 1; v10 = v11; } else { e10 = c->sup ? -1 : c->pos; }
+                      }
+                      if (ok10) { ok9 = 1; v9 = mpcf_free(v10); } else { e9 = e10; }
+                    }
+                    c->sup--; (void)e9;
+                    if (ok9) { ok8 = 1; v8 = v9; } else { e8 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok8) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    mpcf_dtor_null(xs5[0]);
+                    e5 = e8; break;
+                  }
+                  xs5[1] = v8;
+                  ok5 = 1; v5 = mpcf_fst(2, xs5);
+                } while (0);
+              }
+              if (ok5) { ok4 = 1; v4 = lispy_grammar_parse_str_ast(c, v5); } else { e4 = e5; }
+            }
+            if (ok4) { ok3 = 1; v3 = mpc_ast_tag(v4, "char"); } else { e3 = e4; }
+          }
+          if (!ok3) {
+            if (c->bt > 0) { c->pos = p1; c->term = t1; }
+            free(xs1[0]);
+            e1 = e3; break;
+          }
+          xs1[1] = v3;
+          ok1 = 1; v1 = mpcf_state_ast(2, xs1);
+        } while (0);
+      }
+      if (!ok1) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        e0 = e1; break;
+      }
+      xs0[0] = v1;
+      int ok12 = 0; mpc_val_t *v12 = NULL; long e12 = -1;
+      if (depth + 1 == c->max) { e12 = c->sup ? -1 : c->pos; } else {
+        mpc_val_t *s12[8], **xs12 = s12; int j12 = 0, m12 = 8;
+        for (;;) {
+          int ok13 = 0; mpc_val_t *v13 = NULL; long e13 = -1;
+          if (depth + 2 == c->max) { e13 = c->sup ? -1 : c->pos; } else {
+            long p13 = c->pos; int t13 = c->term; mpc_val_t *xs13[2];
+            do {
+              int ok14 = 0; mpc_val_t *v14 = NULL; long e14 = -1;
+              if (depth + 3 == c->max) { e14 = c->sup ? -1 : c->pos; } else {
+                ok14 = 1; v14 = lispy_grammar_parse_state(c);
+              }
+              if (!ok14) {
+                if (c->bt > 0) { c->pos = p13; c->term = t13; }
+                e13 = e14; break;
+              }
+              xs13[0] = v14;
+              int ok15 = 0; mpc_val_t *v15 = NULL; long e15 = -1;
+              if (depth + 3 == c->max) { e15 = c->sup ? -1 : c->pos; } else {
+                int ok16 = 0; mpc_val_t *v16 = NULL; long e16 = -1;
+                if (depth + 4 == c->max) { e16 = c->sup ? -1 : c->pos; } else {
+                  int ok17 = 0; mpc_val_t *v17 = NULL; long e17 = -1;
+                  ok17 = lispy_grammar_parse_22(c, &v17, &e17, depth + 5);
+                  if (ok17) { ok16 = 1; v16 = mpc_ast_add_tag(v17, "expr"); } else { e16 = e17; }
+                }
+                if (ok16) { ok15 = 1; v15 = mpc_ast_add_root(v16); } else { e15 = e16; }
+              }
+              if (!ok15) {
+                if (c->bt > 0) { c->pos = p13; c->term = t13; }
+                free(xs13[0]);
+                e13 = e15; break;
+              }
+              xs13[1] = v15;
+              ok13 = 1; v13 = mpcf_state_ast(2, xs13);
+            } while (0);
+          }
+          if (!ok13) { e12 = e13; break; }
+          lispy_grammar_parse_push(&xs12, &j12, &m12, s12, v13);
+        }
+        ok12 = 1; v12 = mpcf_fold_ast(j12, xs12);
+        if (xs12 != s12) { free(xs12); }
+      }
+      if (!ok12) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        mpc_ast_delete(xs0[0]);
+        e0 = e12; break;
+      }
+      xs0[1] = v12;
+      int ok18 = 0; mpc_val_t *v18 = NULL; long e18 = -1;
+      if (depth + 1 == c->max) { e18 = c->sup ? -1 : c->pos; } else {
+        long p18 = c->pos; int t18 = c->term; mpc_val_t *xs18[2];
+        do {
+          int ok19 = 0; mpc_val_t *v19 = NULL; long e19 = -1;
+          if (depth + 2 == c->max) { e19 = c->sup ? -1 : c->pos; } else {
+            ok19 = 1; v19 = lispy_grammar_parse_state(c);
+          }
+          if (!ok19) {
+            if (c->bt > 0) { c->pos = p18; c->term = t18; }
+            e18 = e19; break;
+          }
+          xs18[0] = v19;
+          int ok20 = 0; mpc_val_t *v20 = NULL; long e20 = -1;
+          if (depth + 2 == c->max) { e20 = c->sup ? -1 : c->pos; } else {
+            int ok21 = 0; mpc_val_t *v21 = NULL; long e21 = -1;
+            if (depth + 3 == c->max) { e21 = c->sup ? -1 : c->pos; } else {
+              int ok22 = 0; mpc_val_t *v22 = NULL; long e22 = -1;
+              if (depth + 4 == c->max) { e22 = c->sup ? -1 : c->pos; } else {
+                long p22 = c->pos; int t22 = c->term; mpc_val_t *xs22[2];
+                do {
+                  int ok23 = 0; mpc_val_t *v23 = NULL; long e23 = -1;
+                  if (depth + 5 == c->max) { e23 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok24 = 0; mpc_val_t *v24 = NULL; long e24 = -1;
+                    if (depth + 6 == c->max) { e24 = c->sup ? -1 : c->pos; } else {
+                      if (c->s[c->pos] == ')') { ok24 = 1; v24 = lispy_grammar_parse_chr(c); }
+                    }
+                    c->sup--; (void)e24;
+                    if (ok24) { ok23 = 1; v23 = v24; } else { e23 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok23) {
+                    if (c->bt > 0) { c->pos = p22; c->term = t22; }
+                    e22 = e23; break;
+                  }
+                  xs22[0] = v23;
+                  int ok25 = 0; mpc_val_t *v25 = NULL; long e25 = -1;
+                  if (depth + 5 == c->max) { e25 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok26 = 0; mpc_val_t *v26 = NULL; long e26 = -1;
+                    if (depth + 6 == c->max) { e26 = c->sup ? -1 : c->pos; } else {
+                      int ok27 = 0; mpc_val_t *v27 = NULL; long e27 = -1;
+                      if (depth + 7 == c->max) { e27 = c->sup ? -1 : c->pos; } else {
+                        c->sup++;
+                        int ok28 = 0; mpc_val_t *v28 = NULL; long e28 = -1;
+                        if (depth + 8 == c->max) { e28 = c->sup ? -1 : c->pos; } else {
+                          char *b28 = NULL; size_t l28 = 0, m28 = 0; long j28 = 0, q28;
+                          for (;;) {
+                            for (q28 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set15, c->s[c->pos]); c->pos++);
+                            lispy_grammar_parse_cat(&b28, &l28, &m28, c->s + q28, c->pos - q28); j28 += c->pos - q28;
+                            e28 = c->sup ? -1 : c->pos;
+                            break;
+                          }
+                          if (j28 >= 0) { ok28 = 1; v28 = b28; e28 = -1; } else { free(b28); }
+                        }
+                        c->sup--; (void)e28;
+                        if (ok28) { ok27 = 1; v27 = v28; } else { e27 = c->sup ? -1 : c->pos; }
+                      }
+                      if (ok27) { ok26 = 1; v26 = mpcf_free(v27); } else { e26 = e27; }
+                    }
+                    c->sup--; (void)e26;
+                    if (ok26) { ok25 = 1; v25 = v26; } else { e25 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok25) {
+                    if (c->bt > 0) { c->pos = p22; c->term = t22; }
+                    mpcf_dtor_null(xs22[0]);
+                    e22 = e25; break;
+                  }
+                  xs22[1] = v25;
+                  ok22 = 1; v22 = mpcf_fst(2, xs22);
+                } while (0);
+              }
+              if (ok22) { ok21 = 1; v21 = lispy_grammar_parse_str_ast(c, v22); } else { e21 = e22; }
+            }
+            if (ok21) { ok20 = 1; v20 = mpc_ast_tag(v21, "char"); } else { e20 = e21; }
+          }
+          if (!ok20) {
+            if (c->bt > 0) { c->pos = p18; c->term = t18; }
+            free(xs18[0]);
+            e18 = e20; break;
+          }
+          xs18[1] = v20;
+          ok18 = 1; v18 = mpcf_state_ast(2, xs18);
+        } while (0);
+      }
+      if (!ok18) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        mpc_ast_delete(xs0[0]);
+        mpc_ast_delete(xs0[1]);
+        e0 = e18; break;
+      }
+      xs0[2] = v18;
+      ok0 = 1; v0 = mpcf_fold_ast(3, xs0);
+    } while (0);
+  }
+  *o = v0;
+  *e = e0;
+  return ok0;
+}
+
+/* qexpr */
+static int lispy_grammar_parse_160(lispy_grammar_parse_ctx_t *c, mpc_val_t **o, long *e, int depth) {
+  int ok0 = 0; mpc_val_t *v0 = NULL; long e0 = -1;
+  if (depth + 0 == c->max) { e0 = c->sup ? -1 : c->pos; } else {
+    long p0 = c->pos; int t0 = c->term; mpc_val_t *xs0[3];
+    do {
+      int ok1 = 0; mpc_val_t *v1 = NULL; long e1 = -1;
+      if (depth + 1 == c->max) { e1 = c->sup ? -1 : c->pos; } else {
+        long p1 = c->pos; int t1 = c->term; mpc_val_t *xs1[2];
+        do {
+          int ok2 = 0; mpc_val_t *v2 = NULL; long e2 = -1;
+          if (depth + 2 == c->max) { e2 = c->sup ? -1 : c->pos; } else {
+            ok2 = 1; v2 = lispy_grammar_parse_state(c);
+          }
+          if (!ok2) {
+            if (c->bt > 0) { c->pos = p1; c->term = t1; }
+            e1 = e2; break;
+          }
+          xs1[0] = v2;
+          int ok3 = 0; mpc_val_t *v3 = NULL; long e3 = -1;
+          if (depth + 2 == c->max) { e3 = c->sup ? -1 : c->pos; } else {
+            int ok4 = 0; mpc_val_t *v4 = NULL; long e4 = -1;
+            if (depth + 3 == c->max) { e4 = c->sup ? -1 : c->pos; } else {
+              int ok5 = 0; mpc_val_t *v5 = NULL; long e5 = -1;
+              if (depth + 4 == c->max) { e5 = c->sup ? -1 : c->pos; } else {
+                long p5 = c->pos; int t5 = c->term; mpc_val_t *xs5[2];
+                do {
+                  int ok6 = 0; mpc_val_t *v6 = NULL; long e6 = -1;
+                  if (depth + 5 == c->max) { e6 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok7 = 0; mpc_val_t *v7 = NULL; long e7 = -1;
+                    if (depth + 6 == c->max) { e7 = c->sup ? -1 : c->pos; } else {
+                      if (c->s[c->pos] == '{') { ok7 = 1; v7 = lispy_grammar_parse_chr(c); }
+                    }
+                    c->sup--; (void)e7;
+                    if (ok7) { ok6 = 1; v6 = v7; } else { e6 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok6) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    e5 = e6; break;
+                  }
+                  xs5[0] = v6;
+                  int ok8 = 0; mpc_val_t *v8 = NULL; long e8 = -1;
+                  if (depth + 5 == c->max) { e8 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok9 = 0; mpc_val_t *v9 = NULL; long e9 = -1;
+                    if (depth + 6 == c->max) { e9 = c->sup ? -1 : c->pos; } else {
+                      int ok10 = 0; mpc_val_t *v10 = NULL; long e10 = -1;
+                      if (depth + 7 == c->max) { e10 = c->sup ? -1 : c->pos; } else {
+                        c->sup++;
+                        int ok11 = 0; mpc_val_t *v11 = NULL; long e11 = -1;
+                        if (depth + 8 == c->max) { e11 = c->sup ? -1 : c->pos; } else {
+                          char *b11 = NULL; size_t l11 = 0, m11 = 0; long j11 = 0, q11;
+                          for (;;) {
+                            for (q11 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set16, c->s[c->pos]); c->pos++);
+                            lispy_grammar_parse_cat(&b11, &l11, &m11, c->s + q11, c->pos - q11); j11 += c->pos - q11;
+                            e11 = c->sup ? -1 : c->pos;
+                            break;
+                          }
+                          if (j11 >= 0) { ok11 = 1; v11 = b11; e11 = -1; } else { free(b11); }
+                        }
+                        c->sup--; (void)e11;
+                        if (ok11) { ok10 = 1; v10 = v11; } else { e10 = c->sup ? -1 : c->pos; }
+                      }
+                      if (ok10) { ok9 = 1; v9 = mpcf_free(v10); } else { e9 = e10; }
+                    }
+                    c->sup--; (void)e9;
+                    if (ok9) { ok8 = 1; v8 = v9; } else { e8 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok8) {
+                    if (c->bt > 0) { c->pos = p5; c->term = t5; }
+                    mpcf_dtor_null(xs5[0]);
+                    e5 = e8; break;
+                  }
+                  xs5[1] = v8;
+                  ok5 = 1; v5 = mpcf_fst(2, xs5);
+                } while (0);
+              }
+              if (ok5) { ok4 = 1; v4 = lispy_grammar_parse_str_ast(c, v5); } else { e4 = e5; }
+            }
+            if (ok4) { ok3 = 1; v3 = mpc_ast_tag(v4, "char"); } else { e3 = e4; }
+          }
+          if (!ok3) {
+            if (c->bt > 0) { c->pos = p1; c->term = t1; }
+            free(xs1[0]);
+            e1 = e3; break;
+          }
+          xs1[1] = v3;
+          ok1 = 1; v1 = mpcf_state_ast(2, xs1);
+        } while (0);
+      }
+      if (!ok1) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        e0 = e1; break;
+      }
+      xs0[0] = v1;
+      int ok12 = 0; mpc_val_t *v12 = NULL; long e12 = -1;
+      if (depth + 1 == c->max) { e12 = c->sup ? -1 : c->pos; } else {
+        mpc_val_t *s12[8], **xs12 = s12; int j12 = 0, m12 = 8;
+        for (;;) {
+          int ok13 = 0; mpc_val_t *v13 = NULL; long e13 = -1;
+          if (depth + 2 == c->max) { e13 = c->sup ? -1 : c->pos; } else {
+            long p13 = c->pos; int t13 = c->term; mpc_val_t *xs13[2];
+            do {
+              int ok14 = 0; mpc_val_t *v14 = NULL; long e14 = -1;
+              if (depth + 3 == c->max) { e14 = c->sup ? -1 : c->pos; } else {
+                ok14 = 1; v14 = lispy_grammar_parse_state(c);
+              }
+              if (!ok14) {
+                if (c->bt > 0) { c->pos = p13; c->term = t13; }
+                e13 = e14; break;
+              }
+              xs13[0] = v14;
+              int ok15 = 0; mpc_val_t *v15 = NULL; long e15 = -1;
+              if (depth + 3 == c->max) { e15 = c->sup ? -1 : c->pos; } else {
+                int ok16 = 0; mpc_val_t *v16 = NULL; long e16 = -1;
+                if (depth + 4 == c->max) { e16 = c->sup ? -1 : c->pos; } else {
+                  int ok17 = 0; mpc_val_t *v17 = NULL; long e17 = -1;
+                  ok17 = lispy_grammar_parse_22(c, &v17, &e17, depth + 5);
+                  if (ok17) { ok16 = 1; v16 = mpc_ast_add_tag(v17, "expr"); } else { e16 = e17; }
+                }
+                if (ok16) { ok15 = 1; v15 = mpc_ast_add_root(v16); } else { e15 = e16; }
+              }
+              if (!ok15) {
+                if (c->bt > 0) { c->pos = p13; c->term = t13; }
+                free(xs13[0]);
+                e13 = e15; break;
+              }
+              xs13[1] = v15;
+              ok13 = 1; v13 = mpcf_state_ast(2, xs13);
+            } while (0);
+          }
+          if (!ok13) { e12 = e13; break; }
+          lispy_grammar_parse_push(&xs12, &j12, &m12, s12, v13);
+        }
+        ok12 = 1; v12 = mpcf_fold_ast(j12, xs12);
+        if (xs12 != s12) { free(xs12); }
+      }
+      if (!ok12) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        mpc_ast_delete(xs0[0]);
+        e0 = e12; break;
+      }
+      xs0[1] = v12;
+      int ok18 = 0; mpc_val_t *v18 = NULL; long e18 = -1;
+      if (depth + 1 == c->max) { e18 = c->sup ? -1 : c->pos; } else {
+        long p18 = c->pos; int t18 = c->term; mpc_val_t *xs18[2];
+        do {
+          int ok19 = 0; mpc_val_t *v19 = NULL; long e19 = -1;
+          if (depth + 2 == c->max) { e19 = c->sup ? -1 : c->pos; } else {
+            ok19 = 1; v19 = lispy_grammar_parse_state(c);
+          }
+          if (!ok19) {
+            if (c->bt > 0) { c->pos = p18; c->term = t18; }
+            e18 = e19; break;
+          }
+          xs18[0] = v19;
+          int ok20 = 0; mpc_val_t *v20 = NULL; long e20 = -1;
+          if (depth + 2 == c->max) { e20 = c->sup ? -1 : c->pos; } else {
+            int ok21 = 0; mpc_val_t *v21 = NULL; long e21 = -1;
+            if (depth + 3 == c->max) { e21 = c->sup ? -1 : c->pos; } else {
+              int ok22 = 0; mpc_val_t *v22 = NULL; long e22 = -1;
+              if (depth + 4 == c->max) { e22 = c->sup ? -1 : c->pos; } else {
+                long p22 = c->pos; int t22 = c->term; mpc_val_t *xs22[2];
+                do {
+                  int ok23 = 0; mpc_val_t *v23 = NULL; long e23 = -1;
+                  if (depth + 5 == c->max) { e23 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok24 = 0; mpc_val_t *v24 = NULL; long e24 = -1;
+                    if (depth + 6 == c->max) { e24 = c->sup ? -1 : c->pos; } else {
+                      if (c->s[c->pos] == '}') { ok24 = 1; v24 = lispy_grammar_parse_chr(c); }
+                    }
+                    c->sup--; (void)e24;
+                    if (ok24) { ok23 = 1; v23 = v24; } else { e23 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok23) {
+                    if (c->bt > 0) { c->pos = p22; c->term = t22; }
+                    e22 = e23; break;
+                  }
+                  xs22[0] = v23;
+                  int ok25 = 0; mpc_val_t *v25 = NULL; long e25 = -1;
+                  if (depth + 5 == c->max) { e25 = c->sup ? -1 : c->pos; } else {
+                    c->sup++;
+                    int ok26 = 0; mpc_val_t *v26 = NULL; long e26 = -1;
+                    if (depth + 6 == c->max) { e26 = c->sup ? -1 : c->pos; } else {
+                      int ok27 = 0; mpc_val_t *v27 = NULL; long e27 = -1;
+                      if (depth + 7 == c->max) { e27 = c->sup ? -1 : c->pos; } else {
+                        c->sup++;
+                        int ok28 = 0; mpc_val_t *v28 = NULL; long e28 = -1;
+                        if (depth + 8 == c->max) { e28 = c->sup ? -1 : c->pos; } else {
+                          char *b28 = NULL; size_t l28 = 0, m28 = 0; long j28 = 0, q28;
+                          for (;;) {
+                            for (q28 = c->pos; lispy_grammar_parse_in(lispy_grammar_parse_set17, c->s[c->pos]); c->pos++);
+                            lispy_grammar_parse_cat(&b28, &l28, &m28, c->s + q28, c->pos - q28); j28 += c->pos - q28;
+                            e28 = c->sup ? -1 : c->pos;
+                            break;
+                          }
+                          if (j28 >= 0) { ok28 = 1; v28 = b28; e28 = -1; } else { free(b28); }
+                        }
+                        c->sup--; (void)e28;
+                        if (ok28) { ok27 = 1; v27 = v28; } else { e27 = c->sup ? -1 : c->pos; }
+                      }
+                      if (ok27) { ok26 = 1; v26 = mpcf_free(v27); } else { e26 = e27; }
+                    }
+                    c->sup--; (void)e26;
+                    if (ok26) { ok25 = 1; v25 = v26; } else { e25 = c->sup ? -1 : c->pos; }
+                  }
+                  if (!ok25) {
+                    if (c->bt > 0) { c->pos = p22; c->term = t22; }
+                    mpcf_dtor_null(xs22[0]);
+                    e22 = e25; break;
+                  }
+                  xs22[1] = v25;
+                  ok22 = 1; v22 = mpcf_fst(2, xs22);
+                } while (0);
+              }
+              if (ok22) { ok21 = 1; v21 = lispy_grammar_parse_str_ast(c, v22); } else { e21 = e22; }
+            }
+            if (ok21) { ok20 = 1; v20 = mpc_ast_tag(v21, "char"); } else { e20 = e21; }
+          }
+          if (!ok20) {
+            if (c->bt > 0) { c->pos = p18; c->term = t18; }
+            free(xs18[0]);
+            e18 = e20; break;
+          }
+          xs18[1] = v20;
+          ok18 = 1; v18 = mpcf_state_ast(2, xs18);
+        } while (0);
+      }
+      if (!ok18) {
+        if (c->bt > 0) { c->pos = p0; c->term = t0; }
+        mpc_ast_delete(xs0[0]);
+        mpc_ast_delete(xs0[1]);
+        e0 = e18; break;
+      }
+      xs0[2] = v18;
+      ok0 = 1; v0 = mpcf_fold_ast(3, xs0);
+    } while (0);
+  }
+  *o = v0;
+  *e = e0;
+  return ok0;
+}
+
+static int lispy_grammar_parse(const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r, int arena) {
+  lispy_grammar_parse_ctx_t c;
+  mpc_val_t *v = NULL;
+  long e = -1;
+  c.s = string; c.pos = 0; c.term = 0; c.bt = 1; c.sup = 0;
+  c.rpos = 0; c.row = 0; c.col = 0;
+  c.max = MPC_MAX_RECURSION_DEPTH;
+  c.arena = arena ? mpc_arena_new() : NULL;
+  if (lispy_grammar_parse_0(&c, &v, &e, 0)) {
+    if (c.arena) { mpc_arena_done(c.arena, v); }
+    r->output = v;
+    return 1;
+  }
+  if (c.arena) { mpc_arena_done(c.arena, NULL); }
+  return arena ? mpc_parse_arena(filename, string, p, r) : mpc_parse(filename, string, p, r);
+}
@@ -75,26 +75,51 @@ typedef struct {
   char mem[64];
 } mpc_mem_t;
 
+/*
+** While parsing the input only keeps its offset.
+** Rows and columns are worked out from an index of
+** the newlines, built as far as is needed, when a
+** state is copied out or an error is exported.
+*/
+
+typedef struct {
+  long pos;
+  int term;
+} mpc_input_state_t;
+
 typedef struct {
 
   int type;
   char *filename;
-  mpc_state_t state;
+  mpc_input_state_t state;
 
   char *string;
+  long length;
   char *buffer;
   FILE *file;
 
   int suppress;
   int backtrack;
+  int lazy;
+  int lazy_first;
+  int max_depth;
+  mpc_err_t err;
+  mpc_arena_t *arena;
   int marks_slots;
   int marks_num;
-  mpc_state_t *marks;
+  mpc_input_state_t *marks;
+
+  int lines_slots;
+  int lines_num;
+  int line;
+  long *lines;
+  long lines_end;
 
   char *lasts;
   char last;
 
   size_t mem_index;
+  size_t mem_used;
   char mem_full[MPC_INPUT_MEM_NUM];
   mpc_mem_t mem[MPC_INPUT_MEM_NUM];
 
@@ -108,22 +133,34 @@ static mpc_input_t *mpc_input_new_string(const char *filename, const char *strin
   strcpy(i->filename, filename);
   i->type = MPC_INPUT_STRING;
 
-  i->state = mpc_state_new();
+  i->state.pos = 0;
+  i->state.term = 0;
 
-  i->string = malloc(strlen(string) + 1);
+  i->length = strlen(string);
+  i->string = malloc(i->length + 1);
   strcpy(i->string, string);
   i->buffer = NULL;
   i->file = NULL;
 
   i->suppress = 0;
+  i->lazy = 0;
+  i->lazy_first = 1;
+  i->arena = NULL;
   i->backtrack = 1;
+  i->max_depth = MPC_MAX_RECURSION_DEPTH;
   i->marks_num = 0;
   i->marks_slots = MPC_INPUT_MARKS_MIN;
-  i->marks = malloc(sizeof(mpc_state_t) * i->marks_slots);
+  i->marks = malloc(sizeof(mpc_input_state_t) * i->marks_slots);
   i->lasts = malloc(sizeof(char) * i->marks_slots);
+  i->lines_slots = 0;
+  i->lines_num = 0;
+  i->line = 0;
+  i->lines = NULL;
+  i->lines_end = 0;
   i->last = '\0';
 
   i->mem_index = 0;
+  i->mem_used = 0;
   memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
 
   return i;
@@ -137,8 +174,10 @@ static mpc_input_t *mpc_input_new_nstring(const char *filename, const char *stri
   strcpy(i->filename, filename);
   i->type = MPC_INPUT_STRING;
 
-  i->state = mpc_state_new();
+  i->state.pos = 0;
+  i->state.term = 0;
 
+  i->length = length;
   i->string = malloc(length + 1);
   strncpy(i->string, string, length);
   i->string[length] = '\0';
@@ -146,14 +185,24 @@ static mpc_input_t *mpc_input_new_nstring(const char *filename, const char *stri
   i->file = NULL;
 
   i->suppress = 0;
+  i->lazy = 0;
+  i->lazy_first = 1;
+  i->arena = NULL;
   i->backtrack = 1;
+  i->max_depth = MPC_MAX_RECURSION_DEPTH;
   i->marks_num = 0;
   i->marks_slots = MPC_INPUT_MARKS_MIN;
-  i->marks = malloc(sizeof(mpc_state_t) * i->marks_slots);
+  i->marks = malloc(sizeof(mpc_input_state_t) * i->marks_slots);
   i->lasts = malloc(sizeof(char) * i->marks_slots);
+  i->lines_slots = 0;
+  i->lines_num = 0;
+  i->line = 0;
+  i->lines = NULL;
+  i->lines_end = 0;
   i->last = '\0';
 
   i->mem_index = 0;
+  i->mem_used = 0;
   memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
 
   return i;
@@ -168,21 +217,32 @@ static mpc_input_t *mpc_input_new_pipe(const char *filename, FILE *pipe) {
   strcpy(i->filename, filename);
 
   i->type = MPC_INPUT_PIPE;
-  i->state = mpc_state_new();
+  i->state.pos = 0;
+  i->state.term = 0;
 
   i->string = NULL;
   i->buffer = NULL;
   i->file = pipe;
 
   i->suppress = 0;
+  i->lazy = 0;
+  i->lazy_first = 1;
+  i->arena = NULL;
   i->backtrack = 1;
+  i->max_depth = MPC_MAX_RECURSION_DEPTH;
   i->marks_num = 0;
   i->marks_slots = MPC_INPUT_MARKS_MIN;
-  i->marks = malloc(sizeof(mpc_state_t) * i->marks_slots);
+  i->marks = malloc(sizeof(mpc_input_state_t) * i->marks_slots);
   i->lasts = malloc(sizeof(char) * i->marks_slots);
+  i->lines_slots = 0;
+  i->lines_num = 0;
+  i->line = 0;
+  i->lines = NULL;
+  i->lines_end = 0;
   i->last = '\0';
 
   i->mem_index = 0;
+  i->mem_used = 0;
   memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
 
   return i;
@@ -196,21 +256,32 @@ static mpc_input_t *mpc_input_new_file(const char *filename, FILE *file) {
   i->filename = malloc(strlen(filename) + 1);
   strcpy(i->filename, filename);
   i->type = MPC_INPUT_FILE;
-  i->state = mpc_state_new();
+  i->state.pos = 0;
+  i->state.term = 0;
 
   i->string = NULL;
   i->buffer = NULL;
   i->file = file;
 
   i->suppress = 0;
+  i->lazy = 0;
+  i->lazy_first = 1;
+  i->arena = NULL;
   i->backtrack = 1;
+  i->max_depth = MPC_MAX_RECURSION_DEPTH;
   i->marks_num = 0;
   i->marks_slots = MPC_INPUT_MARKS_MIN;
-  i->marks = malloc(sizeof(mpc_state_t) * i->marks_slots);
+  i->marks = malloc(sizeof(mpc_input_state_t) * i->marks_slots);
   i->lasts = malloc(sizeof(char) * i->marks_slots);
+  i->lines_slots = 0;
+  i->lines_num = 0;
+  i->line = 0;
+  i->lines = NULL;
+  i->lines_end = 0;
   i->last = '\0';
 
   i->mem_index = 0;
+  i->mem_used = 0;
   memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
 
   return i;
@@ -225,6 +296,7 @@ static void mpc_input_delete(mpc_input_t *i) {
 
   free(i->marks);
   free(i->lasts);
+  free(i->lines);
   free(i);
 }
 
@@ -245,6 +317,7 @@ static void *mpc_malloc(mpc_input_t *i, size_t n) {
     if (!i->mem_full[i->mem_index]) {
       p = (void*)(i->mem + i->mem_index);
       i->mem_full[i->mem_index] = 1;
+      i->mem_used++;
       i->mem_index = (i->mem_index+1) % MPC_INPUT_MEM_NUM;
       return p;
     }
@@ -265,6 +338,7 @@ static void mpc_free(mpc_input_t *i, void *p) {
   if (!mpc_mem_ptr(i, p)) { free(p); return; }
   j = ((size_t)(((char*)p) - ((char*)i->mem))) / sizeof(mpc_mem_t);
   i->mem_full[j] = 0;
+  i->mem_used--;
 }
 
 static void *mpc_realloc(mpc_input_t *i, void *p, size_t n) {
@@ -306,7 +380,7 @@ static void mpc_input_mark(mpc_input_t *i) {
 
   if (i->marks_num > i->marks_slots) {
     i->marks_slots = i->marks_num + i->marks_num / 2;
-    i->marks = realloc(i->marks, sizeof(mpc_state_t) * i->marks_slots);
+    i->marks = realloc(i->marks, sizeof(mpc_input_state_t) * i->marks_slots);
     i->lasts = realloc(i->lasts, sizeof(char) * i->marks_slots);
   }
 
@@ -331,7 +405,7 @@ static void mpc_input_unmark(mpc_input_t *i) {
     i->marks_slots =
       i->marks_num > MPC_INPUT_MARKS_MIN ?
       i->marks_num : MPC_INPUT_MARKS_MIN;
-    i->marks = realloc(i->marks, sizeof(mpc_state_t) * i->marks_slots);
+    i->marks = realloc(i->marks, sizeof(mpc_input_state_t) * i->marks_slots);
     i->lasts = realloc(i->lasts, sizeof(char) * i->marks_slots);
   }
 
@@ -432,6 +506,65 @@ static int mpc_input_terminated(mpc_input_t *i) {
   return mpc_input_peekc(i) == '\0';
 }
 
+/*
+** The newline index holds the offset of every
+** newline before `lines_end`. Strings are searched
+** for them when a row is asked for, while files
+** and pipes can only note them as they are read.
+*/
+
+static void mpc_input_newline(mpc_input_t *i, long pos) {
+  if (pos < i->lines_end) { return; }
+  if (i->lines_num == i->lines_slots) {
+    i->lines_slots = i->lines_slots ? i->lines_slots * 2 : 64;
+    i->lines = realloc(i->lines, sizeof(long) * i->lines_slots);
+  }
+  i->lines[i->lines_num++] = pos;
+  i->lines_end = pos + 1;
+}
+
+static void mpc_input_lines_to(mpc_input_t *i, long pos) {
+  const char *t;
+  if (i->type != MPC_INPUT_STRING) { return; }
+  while (i->lines_end < pos) {
+    t = memchr(i->string + i->lines_end, '\n', pos - i->lines_end);
+    if (t == NULL) { i->lines_end = pos; break; }
+    mpc_input_newline(i, t - i->string);
+  }
+}
+
+/*
+** Lookups mostly come in order, so each starts
+** from the line of the one before.
+*/
+
+static mpc_state_t mpc_input_state_at(mpc_input_t *i, long pos, int term) {
+
+  mpc_state_t s;
+  int l = i->line;
+
+  mpc_input_lines_to(i, pos);
+
+  if (l > i->lines_num) { l = i->lines_num; }
+  while (l < i->lines_num && i->lines[l] < pos) { l++; }
+  while (l > 0 && i->lines[l-1] >= pos) { l--; }
+  i->line = l;
+
+  s.pos = pos;
+  s.row = l;
+  s.col = l ? pos - (i->lines[l-1] + 1) : pos;
+  s.term = term;
+  return s;
+}
+
+/* the state without its row and column, for errors yet to be exported */
+static mpc_state_t mpc_input_state_pos(mpc_input_t *i) {
+  mpc_state_t s = mpc_state_invalid();
+  s.pos = i->state.pos;
+  s.term = i->state.term;
+  return s;
+}
+
 static int mpc_input_failure(mpc_input_t *i, char c) {
 
   switch (i->type) {
@@ -461,14 +594,10 @@ static int mpc_input_success(mpc_input_t *i, char c, char **o) {
     i->buffer[strlen(i->buffer) + 0] = c;
   }
 
+  if (c == '\n' && i->type != MPC_INPUT_STRING) { mpc_input_newline(i, i->state.pos); }
+
   i->last = c;
   i->state.pos++;
-  i->state.col++;
-
-  if (c == '\n') {
-    i->state.col = 0;
-    i->state.row++;
-  }
 
   if (o) {
     (*o) = mpc_malloc(i, 2);
@@ -479,6 +608,33 @@ static int mpc_input_success(mpc_input_t *i, char c, char **o) {
   return 1;
 }
 
+/*
+** Character classes are kept as 256 bit sets
+** of the bytes they accept so testing one is a
+** single lookup rather than a scan of the class
+** string. The terminating zero is never a member.
+*/
+
+enum {
+  MPC_SET_SIZE = 32
+};
+
+static int mpc_set_has(const unsigned char *set, char c) {
+  return (set[(unsigned char)c / 8] >> ((unsigned char)c % 8)) & 1;
+}
+
+static void mpc_set_add(unsigned char *set, char c) {
+  set[(unsigned char)c / 8] |= 1 << ((unsigned char)c % 8);
+}
+
+static void mpc_set_build(unsigned char *set, const char *s, int negate) {
+  int c;
+  memset(set, 0, MPC_SET_SIZE);
+  for (c = 1; c < 256; c++) {
+    if ((strchr(s, c) != NULL) != negate) { mpc_set_add(set, c); }
+  }
+}
+
 static int mpc_input_any(mpc_input_t *i, char **o) {
   char x;
   if (mpc_input_terminated(i)) { return 0; }
@@ -500,18 +656,217 @@ static int mpc_input_range(mpc_input_t *i, char c, char d, char **o) {
   return x >= c && x <= d ? mpc_input_success(i, x, o) : mpc_input_failure(i, x);
 }
 
-static int mpc_input_oneof(mpc_input_t *i, const char *c, char **o) {
+static int mpc_input_class(mpc_input_t *i, const unsigned char *set, char **o) {
   char x;
   if (mpc_input_terminated(i)) { return 0; }
   x = mpc_input_getc(i);
-  return strchr(c, x) != 0 ? mpc_input_success(i, x, o) : mpc_input_failure(i, x);
+  return mpc_set_has(set, x) ? mpc_input_success(i, x, o) : mpc_input_failure(i, x);
+}
+
+/*
+** A scan consumes the longest run of bytes in
+** its `run` set. When few bytes end the run it
+** looks for the first of those `stops` instead,
+** otherwise it tests every byte against the set
+** using a pair of nibble indexed lookup tables.
+*/
+
+enum {
+  MPC_SCAN_STOPS = 4
+};
+
+typedef struct {
+  unsigned char run[MPC_SET_SIZE];
+  unsigned char lower[16];
+  unsigned char upper[16];
+  char stops[MPC_SCAN_STOPS];
+  int nstops;
+} mpc_scan_t;
+
+static void mpc_scan_build(mpc_scan_t *s, const unsigned char *run) {
+
+  int c;
+
+  memcpy(s->run, run, MPC_SET_SIZE);
+  memset(s->lower, 0, sizeof(s->lower));
+  memset(s->upper, 0, sizeof(s->upper));
+  s->nstops = 0;
+
+  for (c = 0; c < 256; c++) {
+    if (mpc_set_has(run, c)) {
+      if (c < 128) { s->lower[c % 16] |= 1 << (c / 16); }
+      else { s->upper[c % 16] |= 1 << (c / 16 - 8); }
+    } else if (s->nstops >= 0 && s->nstops < MPC_SCAN_STOPS) {
+      s->stops[s->nstops++] = c;
+    } else {
+      s->nstops = -1;
+    }
+  }
+
+  if (s->nstops < 0) { s->nstops = 0; }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))) \
+  && !defined(MPC_SCAN_SCALAR)
+
+#include <immintrin.h>
+
+/*
+** The vector scans only load whole blocks which
+** end before `e`, the terminating zero, and return
+** how far the run is known to go. The bytes left
+** after the last whole block are done one at a
+** time. Which scans to use is decided once, when
+** the program starts, by `mpc_scan_detect`.
+*/
+
+static long mpc_scan_stops_sse2(const char *b, const char *e, const mpc_scan_t *s) {
+
+  int k;
+  const char *a = b;
+  unsigned int mask;
+  __m128i v, m;
+
+  while (e - a >= 16) {
+    v = _mm_loadu_si128((const __m128i*)a);
+    m = _mm_setzero_si128();
+    for (k = 0; k < s->nstops; k++) {
+      m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(s->stops[k])));
+    }
+    mask = (unsigned int)_mm_movemask_epi8(m);
+    if (mask) { return (a - b) + __builtin_ctz(mask); }
+    a += 16;
+  }
+
+  return a - b;
+}
+
+__attribute__((target("avx2")))
+static long mpc_scan_stops_avx2(const char *b, const char *e, const mpc_scan_t *s) {
+
+  int k;
+  const char *a = b;
+  unsigned int mask;
+  __m256i v, m;
+
+  while (e - a >= 32) {
+    v = _mm256_loadu_si256((const __m256i*)a);
+    m = _mm256_setzero_si256();
+    for (k = 0; k < s->nstops; k++) {
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(s->stops[k])));
+    }
+    mask = (unsigned int)_mm256_movemask_epi8(m);
+    if (mask) { return (a - b) + __builtin_ctz(mask); }
+    a += 32;
+  }
+
+  return a - b;
+}
+
+__attribute__((target("avx2")))
+static long mpc_scan_class_avx2(const char *b, const char *e, const mpc_scan_t *s) {
+
+  const char *a = b;
+  unsigned int mask;
+  __m256i v, rows, bits;
+  __m256i lower = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)s->lower));
+  __m256i upper = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)s->upper));
+  __m256i nibble = _mm256_set1_epi8(0x0f);
+  __m256i column = _mm256_setr_epi8(
+    1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+    1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+  while (e - a >= 32) {
+    v = _mm256_loadu_si256((const __m256i*)a);
+    rows = _mm256_blendv_epi8(
+      _mm256_shuffle_epi8(lower, _mm256_and_si256(v, nibble)),
+      _mm256_shuffle_epi8(upper, _mm256_and_si256(v, nibble)), v);
+    bits = _mm256_shuffle_epi8(column, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    mask = (unsigned int)_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_and_si256(rows, bits), _mm256_setzero_si256()));
+    if (mask) { return (a - b) + __builtin_ctz(mask); }
+    a += 32;
+  }
+
+  return a - b;
+}
+
+static long (*mpc_scan_stops)(const char*, const char*, const mpc_scan_t*) = mpc_scan_stops_sse2;
+static long (*mpc_scan_class)(const char*, const char*, const mpc_scan_t*) = NULL;
+
+__attribute__((constructor))
+static void mpc_scan_detect(void) {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    mpc_scan_stops = mpc_scan_stops_avx2;
+    mpc_scan_class = mpc_scan_class_avx2;
+  }
+}
+
+#define MPC_SCAN_X86
+
+#endif
+
+static long mpc_scan_span(const char *b, const char *e, const mpc_scan_t *s) {
+
+  const char *t = b;
+
+#ifdef MPC_SCAN_X86
+  if (s->nstops) { t += mpc_scan_stops(b, e, s); }
+  else if (mpc_scan_class) { t += mpc_scan_class(b, e, s); }
+#else
+  (void)e;
+#endif
+
+  while (mpc_set_has(s->run, *t)) { t++; }
+  return t - b;
+}
+
+static void mpc_input_append(mpc_input_t *i, char **o, long *l, long *m, const char *s, long n) {
+  if (*l + n + 1 > *m) {
+    while (*l + n + 1 > *m) { *m *= 2; }
+    *o = mpc_realloc(i, *o, *m);
+  }
+  memcpy(*o + *l, s, n);
+  *l += n;
+  (*o)[*l] = '\0';
 }
 
-static int mpc_input_noneof(mpc_input_t *i, const char *c, char **o) {
+/*
+** Consumes the longest run of characters in the
+** scan's set, appending them to the string `o`
+** of length `l` and capacity `m`. This is what a
+** `many` of a class would produce one character
+** at a time.
+*/
+
+static long mpc_input_scan(mpc_input_t *i, const mpc_scan_t *s, char **o, long *l, long *m) {
+
   char x;
-  if (mpc_input_terminated(i)) { return 0; }
-  x = mpc_input_getc(i);
-  return strchr(c, x) == 0 ? mpc_input_success(i, x, o) : mpc_input_failure(i, x);
+  const char *b;
+  long j = 0;
+
+  if (i->type == MPC_INPUT_STRING) {
+
+    b = i->string + i->state.pos;
+    j = mpc_scan_span(b, i->string + i->length, s);
+
+    i->state.pos += j;
+    if (j) { i->last = b[j-1]; }
+
+    mpc_input_append(i, o, l, m, b, j);
+    return j;
+  }
+
+  while (!mpc_input_terminated(i)) {
+    x = mpc_input_getc(i);
+    if (!mpc_set_has(s->run, x)) { mpc_input_failure(i, x); break; }
+    mpc_input_success(i, x, NULL);
+    mpc_input_append(i, o, l, m, &x, 1);
+    j++;
+  }
+
+  return j;
 }
 
 static int mpc_input_satisfy(mpc_input_t *i, int(*cond)(char), char **o) {
@@ -564,7 +919,7 @@ static int mpc_input_eoi(mpc_input_t* i, char **o) {
 
 static mpc_state_t *mpc_input_state_copy(mpc_input_t *i) {
   mpc_state_t *r = mpc_malloc(i, sizeof(mpc_state_t));
-  memcpy(r, &i->state, sizeof(mpc_state_t));
+  *r = mpc_input_state_at(i, i->state.pos, i->state.term);
   return r;
 }
 
@@ -601,14 +956,12 @@ static void mpc_err_string_cat(char *buffer, int *pos, int *max, char const *fmt
   va_end(va);
 }
 
-static char char_unescape_buffer[4];
-
-static const char *mpc_err_char_unescape(char c) {
+static const char *mpc_err_char_unescape(char c, char *buffer) {
 
-  char_unescape_buffer[0] = '\'';
-  char_unescape_buffer[1] = ' ';
-  char_unescape_buffer[2] = '\'';
-  char_unescape_buffer[3] = '\0';
+  buffer[0] = '\'';
+  buffer[1] = ' ';
+  buffer[2] = '\'';
+  buffer[3] = '\0';
 
   switch (c) {
     case '\a': return "bell";
@@ -621,8 +974,8 @@ static const char *mpc_err_char_unescape(char c) {
     case '\t': return "tab";
     case ' ' : return "space";
     default:
-      char_unescape_buffer[1] = c;
-      return char_unescape_buffer;
+      buffer[1] = c;
+      return buffer;
   }
 
 }
@@ -632,6 +985,7 @@ char *mpc_err_string(mpc_err_t *x) {
   int i;
   int pos = 0;
   int max = 1023;
+  char unescaped[4];
   char *buffer = calloc(1, 1024);
 
   if (x->failure) {
@@ -657,19 +1011,33 @@ char *mpc_err_string(mpc_err_t *x) {
   }
 
   mpc_err_string_cat(buffer, &pos, &max, " at ");
-  mpc_err_string_cat(buffer, &pos, &max, mpc_err_char_unescape(x->received));
+  mpc_err_string_cat(buffer, &pos, &max, mpc_err_char_unescape(x->received, unescaped));
   mpc_err_string_cat(buffer, &pos, &max, "\n");
 
   return realloc(buffer, strlen(buffer) + 1);
 }
 
+/*
+** While a parse is `lazy` no errors are built.
+** A failure only needs to say where it happened,
+** so every error is the same one held in the input
+** with its state updated. It is never merged into
+** others or freed.
+*/
+
+static mpc_err_t *mpc_err_lazy(mpc_input_t *i) {
+  i->err.state = mpc_input_state_pos(i);
+  return &i->err;
+}
+
 static mpc_err_t *mpc_err_new(mpc_input_t *i, const char *expected) {
   mpc_err_t *x;
   if (i->suppress) { return NULL; }
+  if (i->lazy) { return mpc_err_lazy(i); }
   x = mpc_malloc(i, sizeof(mpc_err_t));
   x->filename = mpc_malloc(i, strlen(i->filename) + 1);
   strcpy(x->filename, i->filename);
-  x->state = i->state;
+  x->state = mpc_input_state_pos(i);
   x->expected_num = 1;
   x->expected = mpc_malloc(i, sizeof(char*));
   x->expected[0] = mpc_malloc(i, strlen(expected) + 1);
@@ -682,10 +1050,11 @@ static mpc_err_t *mpc_err_new(mpc_input_t *i, const char *expected) {
 static mpc_err_t *mpc_err_fail(mpc_input_t *i, const char *failure) {
   mpc_err_t *x;
   if (i->suppress) { return NULL; }
+  if (i->lazy) { return mpc_err_lazy(i); }
   x = mpc_malloc(i, sizeof(mpc_err_t));
   x->filename = mpc_malloc(i, strlen(i->filename) + 1);
   strcpy(x->filename, i->filename);
-  x->state = i->state;
+  x->state = mpc_input_state_pos(i);
   x->expected_num = 0;
   x->expected = NULL;
   x->failure = mpc_malloc(i, strlen(failure) + 1);
@@ -710,7 +1079,7 @@ static mpc_err_t *mpc_err_file(const char *filename, const char *failure) {
 
 static void mpc_err_delete_internal(mpc_input_t *i, mpc_err_t *x) {
   int j;
-  if (x == NULL) { return; }
+  if (x == NULL || x == &i->err) { return; }
   for (j = 0; j < x->expected_num; j++) { mpc_free(i, x->expected[j]); }
   mpc_free(i, x->expected);
   mpc_free(i, x->filename);
@@ -720,6 +1089,9 @@ static void mpc_err_delete_internal(mpc_input_t *i, mpc_err_t *x) {
 
 static mpc_err_t *mpc_err_export(mpc_input_t *i, mpc_err_t *x) {
   int j;
+  if (x->state.pos >= 0) {
+    x->state = mpc_input_state_at(i, x->state.pos, x->state.term);
+  }
   for (j = 0; j < x->expected_num; j++) {
     x->expected[j] = mpc_export(i, x->expected[j]);
   }
@@ -751,6 +1123,8 @@ static mpc_err_t *mpc_err_or(mpc_input_t *i, mpc_err_t** x, int n) {
   int j, k, fst;
   mpc_err_t *e;
 
+  if (i->lazy) { return NULL; }
+
   fst = -1;
   for (j = 0; j < n; j++) {
     if (x[j] != NULL) { fst = j; }
@@ -805,6 +1179,7 @@ static mpc_err_t *mpc_err_repeat(mpc_input_t *i, mpc_err_t *x, const char *prefi
   char *expect = NULL;
 
   if (x == NULL) { return NULL; }
+  if (i->lazy) { return x; }
 
   if (x->expected_num == 0) {
     expect = mpc_calloc(i, 1, 1);
@@ -862,6 +1237,7 @@ static mpc_err_t *mpc_err_count(mpc_input_t *i, mpc_err_t *x, int n) {
   mpc_err_t *y;
   int digits = n/10 + 1;
   char *prefix;
+  if (i->lazy) { return x; }
   prefix = mpc_malloc(i, digits + strlen(" of ") + 1);
   sprintf(prefix, "%i of ", n);
   y = mpc_err_repeat(i, x, prefix);
@@ -914,7 +1290,21 @@ enum {
   MPC_TYPE_CHECK_WITH = 26,
 
   MPC_TYPE_SOI        = 27,
-  MPC_TYPE_EOI        = 28
+  MPC_TYPE_EOI        = 28,
+
+  MPC_TYPE_SCAN       = 29
+};
+
+/*
+** Entries of an `or` jump table. Any other
+** value is one plus the index of the single
+** alternative which can start with that byte.
+*/
+
+enum {
+  MPC_JUMP_NONE = 0,
+  MPC_JUMP_MANY = 255,
+  MPC_JUMP_SIZE = 256
 };
 
 typedef struct { char *m; } mpc_pdata_fail_t;
@@ -924,7 +1314,7 @@ typedef struct { int(*f)(char,char); } mpc_pdata_anchor_t;
 typedef struct { char x; } mpc_pdata_single_t;
 typedef struct { char x; char y; } mpc_pdata_range_t;
 typedef struct { int(*f)(char); } mpc_pdata_satisfy_t;
-typedef struct { char *x; } mpc_pdata_string_t;
+typedef struct { char *x; unsigned char set[MPC_SET_SIZE]; } mpc_pdata_string_t;
 typedef struct { mpc_parser_t *x; mpc_apply_t f; } mpc_pdata_apply_t;
 typedef struct { mpc_parser_t *x; mpc_apply_to_t f; void *d; } mpc_pdata_apply_to_t;
 typedef struct { mpc_parser_t *x; mpc_dtor_t dx; mpc_check_t f; char *e; } mpc_pdata_check_t;
@@ -932,7 +1322,8 @@ typedef struct { mpc_parser_t *x; mpc_dtor_t dx; mpc_check_with_t f; void *d; ch
 typedef struct { mpc_parser_t *x; } mpc_pdata_predict_t;
 typedef struct { mpc_parser_t *x; mpc_dtor_t dx; mpc_ctor_t lf; } mpc_pdata_not_t;
 typedef struct { int n; mpc_fold_t f; mpc_parser_t *x; mpc_dtor_t dx; } mpc_pdata_repeat_t;
-typedef struct { int n; mpc_parser_t **xs; } mpc_pdata_or_t;
+typedef struct { int n; mpc_parser_t **xs; unsigned char *jump; } mpc_pdata_or_t;
+typedef struct { int n; mpc_parser_t *x; mpc_scan_t *s; } mpc_pdata_scan_t;
 typedef struct { int n; mpc_fold_t f; mpc_parser_t **xs; mpc_dtor_t *dxs;  } mpc_pdata_and_t;
 
 typedef union {
@@ -953,6 +1344,7 @@ typedef union {
   mpc_pdata_repeat_t repeat;
   mpc_pdata_and_t and;
   mpc_pdata_or_t or;
+  mpc_pdata_scan_t scan;
 } mpc_pdata_t;
 
 struct mpc_parser_t {
@@ -960,8 +1352,14 @@ struct mpc_parser_t {
   mpc_pdata_t data;
   char type;
   char retained;
+  char frozen;
 };
 
+static int mpc_scan_is_class(mpc_parser_t *x) {
+  while (x->type == MPC_TYPE_EXPECT) { x = x->data.expect.x; }
+  return x->type == MPC_TYPE_ONEOF || x->type == MPC_TYPE_NONEOF;
+}
+
 static mpc_val_t *mpcf_input_nth_free(mpc_input_t *i, int n, mpc_val_t **xs, int x) {
   int j;
   for (j = 0; j < n; j++) { if (j != x) { mpc_free(i, xs[j]); } }
@@ -1012,7 +1410,7 @@ static mpc_val_t *mpcf_input_free(mpc_input_t *i, mpc_val_t *x) {
 }
 
 static mpc_val_t *mpcf_input_str_ast(mpc_input_t *i, mpc_val_t *c) {
-  mpc_ast_t *a = mpc_ast_new("", c);
+  mpc_ast_t *a = i->arena ? mpc_arena_ast_new(i->arena, "", c) : mpc_ast_new("", c);
   mpc_free(i, c);
   return a;
 }
@@ -1033,282 +1431,428 @@ static void mpc_parse_dtor(mpc_input_t *i, mpc_dtor_t d, mpc_val_t *x) {
 }
 
 enum {
-  MPC_PARSE_STACK_MIN = 4
+  MPC_PARSE_STACK_MIN  = 4,
+  MPC_PARSE_FRAMES_MIN = 64
 };
 
-#define MPC_SUCCESS(x) r->output = x; return 1
-#define MPC_FAILURE(x) r->error = x; return 0
-#define MPC_PRIMITIVE(x) \
-  if (x) { MPC_SUCCESS(r->output); } \
-  else { MPC_FAILURE(NULL); }
-
-#define MPC_MAX_RECURSION_DEPTH 1000
-
-static int mpc_parse_run(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r, mpc_err_t **e, int depth) {
+/*
+** The parser runs as a machine on an explicit stack
+** of frames rather than by recursion, so its use of
+** the C stack is bounded however deep the input is
+** nested. A frame holds what a combinator needs to
+** carry on once the child it started has finished.
+** Frames start out on the C stack and move to the
+** heap when the nesting goes deeper.
+*/
 
-  int j = 0, k = 0;
-  mpc_result_t results_stk[MPC_PARSE_STACK_MIN];
+typedef struct {
+  mpc_parser_t *p;
+  int j;
+  int slots;
+  long s, l, m;
+  mpc_val_t *x;
   mpc_result_t *results;
-  int results_slots = MPC_PARSE_STACK_MIN;
+  mpc_result_t stk[MPC_PARSE_STACK_MIN];
+} mpc_parse_frame_t;
 
-  if (depth == MPC_MAX_RECURSION_DEPTH)
-  {
-    MPC_FAILURE(mpc_err_fail(i, "Maximum recursion depth exceeded!"));
-  }
+/*
+** Runs the parsers which need no frame, those which
+** do not run others, and says whether `p` was one.
+*/
+
+static int mpc_parse_leaf(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r, int *x) {
 
   switch (p->type) {
 
     /* Basic Parsers */
 
-    case MPC_TYPE_ANY:     MPC_PRIMITIVE(mpc_input_any(i, (char**)&r->output));
-    case MPC_TYPE_SINGLE:  MPC_PRIMITIVE(mpc_input_char(i, p->data.single.x, (char**)&r->output));
-    case MPC_TYPE_RANGE:   MPC_PRIMITIVE(mpc_input_range(i, p->data.range.x, p->data.range.y, (char**)&r->output));
-    case MPC_TYPE_ONEOF:   MPC_PRIMITIVE(mpc_input_oneof(i, p->data.string.x, (char**)&r->output));
-    case MPC_TYPE_NONEOF:  MPC_PRIMITIVE(mpc_input_noneof(i, p->data.string.x, (char**)&r->output));
-    case MPC_TYPE_SATISFY: MPC_PRIMITIVE(mpc_input_satisfy(i, p->data.satisfy.f, (char**)&r->output));
-    case MPC_TYPE_STRING:  MPC_PRIMITIVE(mpc_input_string(i, p->data.string.x, (char**)&r->output));
-    case MPC_TYPE_ANCHOR:  MPC_PRIMITIVE(mpc_input_anchor(i, p->data.anchor.f, (char**)&r->output));
-    case MPC_TYPE_SOI:     MPC_PRIMITIVE(mpc_input_soi(i, (char**)&r->output));
-    case MPC_TYPE_EOI:     MPC_PRIMITIVE(mpc_input_eoi(i, (char**)&r->output));
+    case MPC_TYPE_ANY:     *x = mpc_input_any(i, (char**)&r->output); break;
+    case MPC_TYPE_SINGLE:  *x = mpc_input_char(i, p->data.single.x, (char**)&r->output); break;
+    case MPC_TYPE_RANGE:   *x = mpc_input_range(i, p->data.range.x, p->data.range.y, (char**)&r->output); break;
+    case MPC_TYPE_ONEOF:   *x = mpc_input_class(i, p->data.string.set, (char**)&r->output); break;
+    case MPC_TYPE_NONEOF:  *x = mpc_input_class(i, p->data.string.set, (char**)&r->output); break;
+    case MPC_TYPE_SATISFY: *x = mpc_input_satisfy(i, p->data.satisfy.f, (char**)&r->output); break;
+    case MPC_TYPE_STRING:  *x = mpc_input_string(i, p->data.string.x, (char**)&r->output); break;
+    case MPC_TYPE_ANCHOR:  *x = mpc_input_anchor(i, p->data.anchor.f, (char**)&r->output); break;
+    case MPC_TYPE_SOI:     *x = mpc_input_soi(i, (char**)&r->output); break;
+    case MPC_TYPE_EOI:     *x = mpc_input_eoi(i, (char**)&r->output); break;
 
     /* Other parsers */
 
-    case MPC_TYPE_UNDEFINED: MPC_FAILURE(mpc_err_fail(i, "Parser Undefined!"));
-    case MPC_TYPE_PASS:      MPC_SUCCESS(NULL);
-    case MPC_TYPE_FAIL:      MPC_FAILURE(mpc_err_fail(i, p->data.fail.m));
-    case MPC_TYPE_LIFT:      MPC_SUCCESS(p->data.lift.lf());
-    case MPC_TYPE_LIFT_VAL:  MPC_SUCCESS(p->data.lift.x);
-    case MPC_TYPE_STATE:     MPC_SUCCESS(mpc_input_state_copy(i));
+    case MPC_TYPE_UNDEFINED: *x = 0; r->error = mpc_err_fail(i, "Parser Undefined!"); return 1;
+    case MPC_TYPE_PASS:      *x = 1; r->output = NULL; return 1;
+    case MPC_TYPE_FAIL:      *x = 0; r->error = mpc_err_fail(i, p->data.fail.m); return 1;
+    case MPC_TYPE_LIFT:      *x = 1; r->output = p->data.lift.lf(); return 1;
+    case MPC_TYPE_LIFT_VAL:  *x = 1; r->output = p->data.lift.x; return 1;
+    case MPC_TYPE_STATE:     *x = 1; r->output = mpc_input_state_copy(i); return 1;
 
-    /* Application Parsers */
+    case MPC_TYPE_OR:  if (p->data.or.n)  { return 0; } *x = 1; r->output = NULL; return 1;
+    case MPC_TYPE_AND: if (p->data.and.n) { return 0; } *x = 1; r->output = NULL; return 1;
 
-    case MPC_TYPE_APPLY:
-      if (mpc_parse_run(i, p->data.apply.x, r, e, depth+1)) {
-        MPC_SUCCESS(mpc_parse_apply(i, p->data.apply.f, r->output));
-      } else {
-        MPC_FAILURE(r->output);
-      }
+    default: return 0;
+  }
 
-    case MPC_TYPE_APPLY_TO:
-      if (mpc_parse_run(i, p->data.apply_to.x, r, e, depth+1)) {
-        MPC_SUCCESS(mpc_parse_apply_to(i, p->data.apply_to.f, r->output, p->data.apply_to.d));
-      } else {
-        MPC_FAILURE(r->error);
-      }
+  if (!*x) { r->error = NULL; }
+  return 1;
+}
 
-    case MPC_TYPE_CHECK:
-      if (mpc_parse_run(i, p->data.check.x, r, e, depth+1)) {
-        if (p->data.check.f(&r->output)) {
-          MPC_SUCCESS(r->output);
-        } else {
-          mpc_parse_dtor(i, p->data.check.dx, r->output);
-          MPC_FAILURE(mpc_err_fail(i, p->data.check.e));
-        }
-      } else {
-        MPC_FAILURE(r->error);
+/*
+** `down` is set while starting the parser `p`, and
+** cleared while handing the result `x`/`y` of the
+** parser which just finished to the frame above it.
+*/
+
+#define MPC_CALL(c) p = c; down = 1; break
+#define MPC_SUCCESS(v) y.output = v; x = 1; n--; break
+#define MPC_FAILURE(v) y.error = v; x = 0; n--; break
+#define MPC_RESULTS(f) ((f)->results ? (f)->results : (f)->stk)
+#define MPC_RESULTS_FREE(f) if ((f)->results) { mpc_free(i, (f)->results); }
+
+static int mpc_parse_run(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r, mpc_err_t **e) {
+
+  int k, x = 0, n = 0, down = 1;
+  int depth = i->max_depth;
+  int frames_slots = MPC_PARSE_FRAMES_MIN;
+  mpc_parse_frame_t frames_stk[MPC_PARSE_FRAMES_MIN];
+  mpc_parse_frame_t *frames = frames_stk;
+  mpc_parse_frame_t *f;
+  mpc_result_t *results;
+  mpc_result_t y;
+
+  for (;;) {
+
+    if (down) {
+
+      down = 0;
+
+      if (n == depth) {
+        x = 0; y.error = mpc_err_fail(i, "Maximum recursion depth exceeded!");
+        continue;
       }
 
-    case MPC_TYPE_CHECK_WITH:
-      if (mpc_parse_run(i, p->data.check_with.x, r, e, depth+1)) {
-        if (p->data.check_with.f(&r->output, p->data.check_with.d)) {
-          MPC_SUCCESS(r->output);
+      if (mpc_parse_leaf(i, p, &y, &x)) { continue; }
+
+      if (n == frames_slots) {
+        frames_slots *= 2;
+        if (frames == frames_stk) {
+          frames = malloc(sizeof(mpc_parse_frame_t) * frames_slots);
+          memcpy(frames, frames_stk, sizeof(mpc_parse_frame_t) * n);
         } else {
-          mpc_parse_dtor(i, p->data.check.dx, r->output);
-          MPC_FAILURE(mpc_err_fail(i, p->data.check_with.e));
+          frames = realloc(frames, sizeof(mpc_parse_frame_t) * frames_slots);
         }
-      } else {
-        MPC_FAILURE(r->error);
       }
 
-    case MPC_TYPE_EXPECT:
-      mpc_input_suppress_enable(i);
-      if (mpc_parse_run(i, p->data.expect.x, r, e, depth+1)) {
-        mpc_input_suppress_disable(i);
-        MPC_SUCCESS(r->output);
-      } else {
-        mpc_input_suppress_disable(i);
-        MPC_FAILURE(mpc_err_new(i, p->data.expect.m));
-      }
+      f = &frames[n++];
+      f->p = p;
+      f->j = 0;
+      f->results = NULL;
 
-    case MPC_TYPE_PREDICT:
-      mpc_input_backtrack_disable(i);
-      if (mpc_parse_run(i, p->data.predict.x, r, e, depth+1)) {
-        mpc_input_backtrack_enable(i);
-        MPC_SUCCESS(r->output);
-      } else {
-        mpc_input_backtrack_enable(i);
-        MPC_FAILURE(r->error);
-      }
+      switch (p->type) {
 
-    /* Optional Parsers */
+        /* Application Parsers */
 
-    /* TODO: Update Not Error Message */
+        case MPC_TYPE_APPLY:      MPC_CALL(p->data.apply.x);
+        case MPC_TYPE_APPLY_TO:   MPC_CALL(p->data.apply_to.x);
+        case MPC_TYPE_CHECK:      MPC_CALL(p->data.check.x);
+        case MPC_TYPE_CHECK_WITH: MPC_CALL(p->data.check_with.x);
 
-    case MPC_TYPE_NOT:
-      mpc_input_mark(i);
-      mpc_input_suppress_enable(i);
-      if (mpc_parse_run(i, p->data.not.x, r, e, depth+1)) {
-        mpc_input_rewind(i);
-        mpc_input_suppress_disable(i);
-        mpc_parse_dtor(i, p->data.not.dx, r->output);
-        MPC_FAILURE(mpc_err_new(i, "opposite"));
-      } else {
-        mpc_input_unmark(i);
-        mpc_input_suppress_disable(i);
-        MPC_SUCCESS(p->data.not.lf());
-      }
+        case MPC_TYPE_EXPECT:
+          mpc_input_suppress_enable(i);
+          MPC_CALL(p->data.expect.x);
 
-    case MPC_TYPE_MAYBE:
-      if (mpc_parse_run(i, p->data.not.x, r, e, depth+1)) {
-        MPC_SUCCESS(r->output);
-      } else {
-        *e = mpc_err_merge(i, *e, r->error);
-        MPC_SUCCESS(p->data.not.lf());
-      }
+        case MPC_TYPE_PREDICT:
+          mpc_input_backtrack_disable(i);
+          MPC_CALL(p->data.predict.x);
 
-    /* Repeat Parsers */
+        /* Optional Parsers */
 
-    case MPC_TYPE_MANY:
+        case MPC_TYPE_NOT:
+          mpc_input_mark(i);
+          mpc_input_suppress_enable(i);
+          MPC_CALL(p->data.not.x);
 
-      results = results_stk;
-
-      while (mpc_parse_run(i, p->data.repeat.x, &results[j], e, depth+1)) {
-        j++;
-        if (j == MPC_PARSE_STACK_MIN) {
-          results_slots = j + j / 2;
-          results = mpc_malloc(i, sizeof(mpc_result_t) * results_slots);
-          memcpy(results, results_stk, sizeof(mpc_result_t) * MPC_PARSE_STACK_MIN);
-        } else if (j >= results_slots) {
-          results_slots = j + j / 2;
-          results = mpc_realloc(i, results, sizeof(mpc_result_t) * results_slots);
-        }
-      }
+        case MPC_TYPE_MAYBE: MPC_CALL(p->data.not.x);
 
-      *e = mpc_err_merge(i, *e, results[j].error);
+        /* Repeat Parsers */
 
-      MPC_SUCCESS(
-        mpc_parse_fold(i, p->data.repeat.f, j, (mpc_val_t**)results);
-        if (j >= MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
+        case MPC_TYPE_MANY:
+        case MPC_TYPE_MANY1:
+          f->slots = MPC_PARSE_STACK_MIN;
+          MPC_CALL(p->data.repeat.x);
 
-    case MPC_TYPE_MANY1:
+        case MPC_TYPE_COUNT:
+          if (p->data.repeat.n > MPC_PARSE_STACK_MIN) {
+            f->results = mpc_malloc(i, sizeof(mpc_result_t) * p->data.repeat.n);
+          }
+          MPC_CALL(p->data.repeat.x);
+
+        case MPC_TYPE_SCAN:
+          f->s = 0; f->l = 0; f->m = 16;
+          f->x = mpc_calloc(i, 1, f->m);
+          break;
+
+        /* Combinatory Parsers */
+
+        /*
+        ** If the next byte can only start one of the
+        ** alternatives jump straight to it. Should it
+        ** fail further along the input the others can
+        ** neither match nor contribute to the error, so
+        ** only a failure right here falls through to
+        ** trying every alternative in order.
+        */
+
+        case MPC_TYPE_OR:
+          if (p->data.or.jump) {
+            k = p->data.or.jump[(unsigned char)mpc_input_peekc(i)];
+            if (k != MPC_JUMP_NONE && k != MPC_JUMP_MANY) {
+              f->j = -1;
+              f->s = i->state.pos;
+              MPC_CALL(p->data.or.xs[k-1]);
+            }
+          }
+          MPC_CALL(p->data.or.xs[0]);
 
-      results = results_stk;
-
-      while (mpc_parse_run(i, p->data.repeat.x, &results[j], e, depth+1)) {
-        j++;
-        if (j == MPC_PARSE_STACK_MIN) {
-          results_slots = j + j / 2;
-          results = mpc_malloc(i, sizeof(mpc_result_t) * results_slots);
-          memcpy(results, results_stk, sizeof(mpc_result_t) * MPC_PARSE_STACK_MIN);
-        } else if (j >= results_slots) {
-          results_slots = j + j / 2;
-          results = mpc_realloc(i, results, sizeof(mpc_result_t) * results_slots);
-        }
+        case MPC_TYPE_AND:
+          if (p->data.and.n > MPC_PARSE_STACK_MIN) {
+            f->results = mpc_malloc(i, sizeof(mpc_result_t) * p->data.and.n);
+          }
+          mpc_input_mark(i);
+          MPC_CALL(p->data.and.xs[0]);
+
+        /* End */
+
+        default:
+          n--;
+          x = 0; y.error = mpc_err_fail(i, "Unknown Parser Type Id!");
+          break;
       }
 
-      if (j == 0) {
-        MPC_FAILURE(
-          mpc_err_many1(i, results[j].error);
-          if (j >= MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-      } else {
+      /* a scan goes on to take its first run itself */
+      if (down) { continue; }
+    }
 
-        *e = mpc_err_merge(i, *e, results[j].error);
+    if (n == 0) {
+      *r = y;
+      if (frames != frames_stk) { free(frames); }
+      return x;
+    }
 
-        MPC_SUCCESS(
-          mpc_parse_fold(i, p->data.repeat.f, j, (mpc_val_t**)results);
-          if (j >= MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-      }
+    f = &frames[n-1];
 
-    case MPC_TYPE_COUNT:
+    switch (f->p->type) {
 
-      results = p->data.repeat.n > MPC_PARSE_STACK_MIN
-        ? mpc_malloc(i, sizeof(mpc_result_t) * p->data.repeat.n)
-        : results_stk;
+      /* Application Parsers */
 
-      while (mpc_parse_run(i, p->data.repeat.x, &results[j], e, depth+1)) {
-        j++;
-        if (j == p->data.repeat.n) { break; }
-      }
+      case MPC_TYPE_APPLY:
+        if (x) { MPC_SUCCESS(mpc_parse_apply(i, f->p->data.apply.f, y.output)); }
+        MPC_FAILURE(y.error);
 
-      if (j == p->data.repeat.n) {
-        MPC_SUCCESS(
-          mpc_parse_fold(i, p->data.repeat.f, j, (mpc_val_t**)results);
-          if (p->data.repeat.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-      } else {
-        for (k = 0; k < j; k++) {
-          mpc_parse_dtor(i, p->data.repeat.dx, results[k].output);
+      case MPC_TYPE_APPLY_TO:
+        if (x) { MPC_SUCCESS(mpc_parse_apply_to(i, f->p->data.apply_to.f, y.output, f->p->data.apply_to.d)); }
+        MPC_FAILURE(y.error);
+
+      case MPC_TYPE_CHECK:
+        if (!x) { MPC_FAILURE(y.error); }
+        if (f->p->data.check.f(&y.output)) { MPC_SUCCESS(y.output); }
+        mpc_parse_dtor(i, f->p->data.check.dx, y.output);
+        MPC_FAILURE(mpc_err_fail(i, f->p->data.check.e));
+
+      case MPC_TYPE_CHECK_WITH:
+        if (!x) { MPC_FAILURE(y.error); }
+        if (f->p->data.check_with.f(&y.output, f->p->data.check_with.d)) { MPC_SUCCESS(y.output); }
+        mpc_parse_dtor(i, f->p->data.check_with.dx, y.output);
+        MPC_FAILURE(mpc_err_fail(i, f->p->data.check_with.e));
+
+      case MPC_TYPE_EXPECT:
+        mpc_input_suppress_disable(i);
+        if (x) { MPC_SUCCESS(y.output); }
+        MPC_FAILURE(mpc_err_new(i, f->p->data.expect.m));
+
+      case MPC_TYPE_PREDICT:
+        mpc_input_backtrack_enable(i);
+        if (x) { MPC_SUCCESS(y.output); }
+        MPC_FAILURE(y.error);
+
+      /* Optional Parsers */
+
+      /* TODO: Update Not Error Message */
+
+      case MPC_TYPE_NOT:
+        if (x) {
+          mpc_input_rewind(i);
+          mpc_input_suppress_disable(i);
+          mpc_parse_dtor(i, f->p->data.not.dx, y.output);
+          MPC_FAILURE(mpc_err_new(i, "opposite"));
+        }
+        mpc_input_unmark(i);
+        mpc_input_suppress_disable(i);
+        MPC_SUCCESS(f->p->data.not.lf());
+
+      case MPC_TYPE_MAYBE:
+        if (x) { MPC_SUCCESS(y.output); }
+        *e = mpc_err_merge(i, *e, y.error);
+        MPC_SUCCESS(f->p->data.not.lf());
+
+      /* Repeat Parsers */
+
+      case MPC_TYPE_MANY:
+      case MPC_TYPE_MANY1:
+
+        if (x) {
+          MPC_RESULTS(f)[f->j++] = y;
+          if (f->j == MPC_PARSE_STACK_MIN) {
+            f->slots = f->j + f->j / 2;
+            f->results = mpc_malloc(i, sizeof(mpc_result_t) * f->slots);
+            memcpy(f->results, f->stk, sizeof(mpc_result_t) * MPC_PARSE_STACK_MIN);
+          } else if (f->j >= f->slots) {
+            f->slots = f->j + f->j / 2;
+            f->results = mpc_realloc(i, f->results, sizeof(mpc_result_t) * f->slots);
+          }
+          MPC_CALL(f->p->data.repeat.x);
         }
-        MPC_FAILURE(
-          mpc_err_count(i, results[j].error, p->data.repeat.n);
-          if (p->data.repeat.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-      }
 
-    /* Combinatory Parsers */
+        if (f->j == 0 && f->p->type == MPC_TYPE_MANY1) {
+          MPC_FAILURE(mpc_err_many1(i, y.error));
+        }
 
-    case MPC_TYPE_OR:
+        *e = mpc_err_merge(i, *e, y.error);
+        results = MPC_RESULTS(f);
+        y.output = mpc_parse_fold(i, f->p->data.repeat.f, f->j, (mpc_val_t**)results);
+        MPC_RESULTS_FREE(f);
+        MPC_SUCCESS(y.output);
+
+      /*
+      ** A fused `many` or `many1`. Runs of characters
+      ** in the scan set are taken directly and only the
+      ** character ending a run is given to the repeated
+      ** parser. When that is just the class of the scan
+      ** the error is the one the class would have given
+      ** on the character which ended the run.
+      */
+
+      case MPC_TYPE_SCAN:
+
+        if (f->s && x) {
+          mpc_input_append(i, (char**)&f->x, &f->l, &f->m, y.output, strlen(y.output));
+          mpc_free(i, y.output);
+          f->j++;
+        }
 
-      if (p->data.or.n == 0) { MPC_SUCCESS(NULL); }
+        if (!f->s || x) {
+          f->s = 1;
+          f->j += mpc_input_scan(i, f->p->data.scan.s, (char**)&f->x, &f->l, &f->m);
+          if (!mpc_scan_is_class(f->p->data.scan.x)) { MPC_CALL(f->p->data.scan.x); }
+          y.error = f->p->data.scan.x->type == MPC_TYPE_EXPECT
+            ? mpc_err_new(i, f->p->data.scan.x->data.expect.m) : NULL;
+        }
 
-      results = p->data.or.n > MPC_PARSE_STACK_MIN
-        ? mpc_malloc(i, sizeof(mpc_result_t) * p->data.or.n)
-        : results_stk;
+        if (f->j < f->p->data.scan.n) {
+          mpc_free(i, f->x);
+          MPC_FAILURE(mpc_err_many1(i, y.error));
+        }
+        *e = mpc_err_merge(i, *e, y.error);
+        MPC_SUCCESS(f->x);
 
-      for (j = 0; j < p->data.or.n; j++) {
-        if (mpc_parse_run(i, p->data.or.xs[j], &results[j], e, depth+1)) {
-          MPC_SUCCESS(results[j].output;
-            if (p->data.or.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-        } else {
-          *e = mpc_err_merge(i, *e, results[j].error);
+      case MPC_TYPE_COUNT:
+
+        results = MPC_RESULTS(f);
+
+        if (x) {
+          results[f->j++] = y;
+          if (f->j < f->p->data.repeat.n) { MPC_CALL(f->p->data.repeat.x); }
+          y.output = mpc_parse_fold(i, f->p->data.repeat.f, f->j, (mpc_val_t**)results);
+          MPC_RESULTS_FREE(f);
+          MPC_SUCCESS(y.output);
         }
-      }
 
-      MPC_FAILURE(NULL;
-        if (p->data.or.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
+        for (k = 0; k < f->j; k++) {
+          mpc_parse_dtor(i, f->p->data.repeat.dx, results[k].output);
+        }
+        MPC_RESULTS_FREE(f);
+        MPC_FAILURE(mpc_err_count(i, y.error, f->p->data.repeat.n));
 
-    case MPC_TYPE_AND:
+      /* Combinatory Parsers */
 
-      if (p->data.and.n == 0) { MPC_SUCCESS(NULL); }
+      case MPC_TYPE_OR:
 
-      results = p->data.or.n > MPC_PARSE_STACK_MIN
-        ? mpc_malloc(i, sizeof(mpc_result_t) * p->data.or.n)
-        : results_stk;
+        if (x) { MPC_SUCCESS(y.output); }
 
-      mpc_input_mark(i);
-      for (j = 0; j < p->data.and.n; j++) {
-        if (!mpc_parse_run(i, p->data.and.xs[j], &results[j], e, depth+1)) {
+        if (f->j < 0) {
+          if (y.error && y.error->state.pos > f->s) {
+            *e = mpc_err_merge(i, *e, y.error);
+            MPC_FAILURE(NULL);
+          }
+          mpc_err_delete_internal(i, y.error);
+          f->j = 0;
+          MPC_CALL(f->p->data.or.xs[0]);
+        }
+
+        *e = mpc_err_merge(i, *e, y.error);
+        if (++f->j < f->p->data.or.n) { MPC_CALL(f->p->data.or.xs[f->j]); }
+        MPC_FAILURE(NULL);
+
+      case MPC_TYPE_AND:
+
+        results = MPC_RESULTS(f);
+
+        if (!x) {
           mpc_input_rewind(i);
-          for (k = 0; k < j; k++) {
-            mpc_parse_dtor(i, p->data.and.dxs[k], results[k].output);
+          for (k = 0; k < f->j; k++) {
+            mpc_parse_dtor(i, f->p->data.and.dxs[k], results[k].output);
           }
-          MPC_FAILURE(results[j].error;
-            if (p->data.or.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
+          MPC_RESULTS_FREE(f);
+          MPC_FAILURE(y.error);
         }
-      }
-      mpc_input_unmark(i);
-      MPC_SUCCESS(
-        mpc_parse_fold(i, p->data.and.f, j, (mpc_val_t**)results);
-        if (p->data.or.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
 
-    /* End */
+        results[f->j++] = y;
+        if (f->j < f->p->data.and.n) { MPC_CALL(f->p->data.and.xs[f->j]); }
+        mpc_input_unmark(i);
+        y.output = mpc_parse_fold(i, f->p->data.and.f, f->j, (mpc_val_t**)results);
+        MPC_RESULTS_FREE(f);
+        MPC_SUCCESS(y.output);
 
-    default:
+      default: break;
+    }
 
-      MPC_FAILURE(mpc_err_fail(i, "Unknown Parser Type Id!"));
   }
 
-  return 0;
-
 }
 
+#undef MPC_CALL
 #undef MPC_SUCCESS
 #undef MPC_FAILURE
-#undef MPC_PRIMITIVE
+#undef MPC_RESULTS
+#undef MPC_RESULTS_FREE
+
+/*
+** Parses are first run lazily, building no errors,
+** as most succeed. Only when one fails is it run
+** again from the start to build the error. Pipes
+** can not be read again so they build errors as
+** they go.
+*/
 
 int mpc_parse_input(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r) {
   int x;
-  mpc_err_t *e = mpc_err_fail(i, "Unknown Error");
+  mpc_err_t *e = NULL;
+
+  if (i->type != MPC_INPUT_PIPE && i->backtrack > 0 && i->lazy_first) {
+    mpc_input_mark(i);
+    i->lazy = 1;
+    x = mpc_parse_run(i, p, r, &e);
+    i->lazy = 0;
+    if (x) {
+      mpc_input_unmark(i);
+      r->output = mpc_export(i, r->output);
+      return x;
+    }
+    mpc_input_rewind(i);
+  }
+
+  e = mpc_err_fail(i, "Unknown Error");
   e->state = mpc_state_invalid();
-  x = mpc_parse_run(i, p, r, &e, 0);
+  x = mpc_parse_run(i, p, r, &e);
   if (x) {
     mpc_err_delete_internal(i, e);
     r->output = mpc_export(i, r->output);
@@ -1318,6 +1862,17 @@ int mpc_parse_input(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r) {
   return x;
 }
 
+/*
+** A parse only ever reads the parsers it runs, and
+** all it changes, the maximum depth included, is
+** kept in the input, so once a grammar is frozen
+** with `mpc_freeze` any number of threads may parse
+** with it at once, each with its own input or
+** context. Frozen parsers can not be defined or
+** optimised again, only deleted once no parse is
+** using them.
+*/
+
 int mpc_parse(const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r) {
   int x;
   mpc_input_t *i = mpc_input_new_string(filename, string);
@@ -1326,8 +1881,23 @@ int mpc_parse(const char *filename, const char *string, mpc_parser_t *p, mpc_res
   return x;
 }
 
-int mpc_nparse(const char *filename, const char *string, size_t length, mpc_parser_t *p, mpc_result_t *r) {
-  int x;
+/*
+** Like mpc_parse but building the AST in an arena.
+** The parser must output an AST (or nothing).
+*/
+
+int mpc_parse_arena(const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r) {
+  int x;
+  mpc_input_t *i = mpc_input_new_string(filename, string);
+  i->arena = mpc_arena_new();
+  x = mpc_parse_input(i, p, r);
+  mpc_arena_done(i->arena, x ? r->output : NULL);
+  mpc_input_delete(i);
+  return x;
+}
+
+int mpc_nparse(const char *filename, const char *string, size_t length, mpc_parser_t *p, mpc_result_t *r) {
+  int x;
   mpc_input_t *i = mpc_input_new_nstring(filename, string, length);
   x = mpc_parse_input(i, p, r);
   mpc_input_delete(i);
@@ -1353,6 +1923,8 @@ int mpc_parse_pipe(const char *filename, FILE *pipe, mpc_parser_t *p, mpc_result
 int mpc_parse_contents(const char *filename, mpc_parser_t *p, mpc_result_t *r) {
 
   FILE *f = fopen(filename, "rb");
+  char *s;
+  long n;
   int res;
 
   if (f == NULL) {
@@ -1361,11 +1933,134 @@ int mpc_parse_contents(const char *filename, mpc_parser_t *p, mpc_result_t *r) {
     return 0;
   }
 
+  /*
+  ** Files which can be sized are read whole and
+  ** parsed as strings, so runs of characters can
+  ** be scanned directly in memory.
+  */
+
+  if (fseek(f, 0, SEEK_END) == 0 && (n = ftell(f)) >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+    s = malloc(n + 1);
+    if (fread(s, 1, n, f) == (size_t)n) {
+      fclose(f);
+      res = mpc_nparse(filename, s, n, p, r);
+      free(s);
+      return res;
+    }
+    free(s);
+    rewind(f);
+  }
+
   res = mpc_parse_file(filename, f, p, r);
   fclose(f);
   return res;
 }
 
+/*
+** Parse Contexts
+**
+** A context is an input kept between parses of
+** strings, so each parse only resets it. Its marks,
+** newline index and memory pool are all reused, and
+** the string and filename are borrowed rather than
+** copied. A context may only run one parse at once,
+** but each thread can keep one of its own.
+*/
+
+struct mpc_context_t {
+  mpc_input_t input;
+};
+
+mpc_context_t *mpc_context_new(void) {
+
+  mpc_context_t *c = malloc(sizeof(mpc_context_t));
+  mpc_input_t *i = &c->input;
+
+  i->filename = NULL;
+  i->type = MPC_INPUT_STRING;
+  i->string = NULL;
+  i->buffer = NULL;
+  i->file = NULL;
+
+  i->lazy_first = 1;
+  i->max_depth = MPC_MAX_RECURSION_DEPTH;
+  i->marks_slots = MPC_INPUT_MARKS_MIN;
+  i->marks = malloc(sizeof(mpc_input_state_t) * i->marks_slots);
+  i->lasts = malloc(sizeof(char) * i->marks_slots);
+  i->lines_slots = 0;
+  i->lines = NULL;
+
+  i->mem_index = 0;
+  i->mem_used = 0;
+  memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
+
+  return c;
+}
+
+void mpc_context_set_max_depth(mpc_context_t *c, int depth) {
+  c->input.max_depth = depth;
+}
+
+void mpc_context_set_lazy(mpc_context_t *c, int lazy) {
+  c->input.lazy_first = lazy;
+}
+
+void mpc_context_delete(mpc_context_t *c) {
+  free(c->input.marks);
+  free(c->input.lasts);
+  free(c->input.lines);
+  free(c);
+}
+
+/*
+** Only a parse which left values in the pool, such
+** as one whose output was lifted from it, needs the
+** pool cleared.
+*/
+
+static mpc_input_t *mpc_context_reset(mpc_context_t *c, const char *filename, const char *string) {
+
+  mpc_input_t *i = &c->input;
+
+  i->filename = (char*)filename;
+  i->string = (char*)string;
+  i->length = strlen(string);
+  i->state.pos = 0;
+  i->state.term = 0;
+
+  i->suppress = 0;
+  i->lazy = 0;
+  i->arena = NULL;
+  i->backtrack = 1;
+  i->marks_num = 0;
+  i->last = '\0';
+
+  i->lines_num = 0;
+  i->line = 0;
+  i->lines_end = 0;
+
+  if (i->mem_used) {
+    i->mem_used = 0;
+    memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
+  }
+
+  return i;
+}
+
+int mpc_context_parse(mpc_context_t *c, const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r) {
+  return mpc_parse_input(mpc_context_reset(c, filename, string), p, r);
+}
+
+int mpc_context_parse_arena(mpc_context_t *c, const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r) {
+  int x;
+  mpc_input_t *i = mpc_context_reset(c, filename, string);
+  i->arena = mpc_arena_new();
+  x = mpc_parse_input(i, p, r);
+  mpc_arena_done(i->arena, x ? r->output : NULL);
+  i->arena = NULL;
+  return x;
+}
+
 /*
 ** Building a Parser
 */
@@ -1379,6 +2074,7 @@ static void mpc_undefine_or(mpc_parser_t *p) {
     mpc_undefine_unretained(p->data.or.xs[i], 0);
   }
   free(p->data.or.xs);
+  free(p->data.or.jump);
 
 }
 
@@ -1427,6 +2123,11 @@ static void mpc_undefine_unretained(mpc_parser_t *p, int force) {
       mpc_undefine_unretained(p->data.repeat.x, 0);
       break;
 
+    case MPC_TYPE_SCAN:
+      mpc_undefine_unretained(p->data.scan.x, 0);
+      free(p->data.scan.s);
+      break;
+
     case MPC_TYPE_OR:  mpc_undefine_or(p);  break;
     case MPC_TYPE_AND: mpc_undefine_and(p); break;
 
@@ -1536,11 +2237,22 @@ mpc_parser_t *mpc_copy(mpc_parser_t *a) {
       p->data.repeat.x = mpc_copy(a->data.repeat.x);
       break;
 
+    case MPC_TYPE_SCAN:
+      p->data.scan.x = mpc_copy(a->data.scan.x);
+      p->data.scan.s = malloc(sizeof(mpc_scan_t));
+      memcpy(p->data.scan.s, a->data.scan.s, sizeof(mpc_scan_t));
+      break;
+
     case MPC_TYPE_OR:
       p->data.or.xs = malloc(a->data.or.n * sizeof(mpc_parser_t*));
       for (i = 0; i < a->data.or.n; i++) {
         p->data.or.xs[i] = mpc_copy(a->data.or.xs[i]);
       }
+      p->data.or.jump = NULL;
+      if (a->data.or.jump) {
+        p->data.or.jump = malloc(MPC_JUMP_SIZE);
+        memcpy(p->data.or.jump, a->data.or.jump, MPC_JUMP_SIZE);
+      }
     break;
     case MPC_TYPE_AND:
       p->data.and.xs = malloc(a->data.and.n * sizeof(mpc_parser_t*));
@@ -1579,6 +2291,11 @@ mpc_parser_t *mpc_undefine(mpc_parser_t *p) {
 
 mpc_parser_t *mpc_define(mpc_parser_t *p, mpc_parser_t *a) {
 
+  if (p->frozen) {
+    mpc_delete(a);
+    return NULL;
+  }
+
   if (p->retained) {
     p->type = a->type;
     p->data = a->data;
@@ -1764,6 +2481,7 @@ mpc_parser_t *mpc_oneof(const char *s) {
   p->type = MPC_TYPE_ONEOF;
   p->data.string.x = malloc(strlen(s) + 1);
   strcpy(p->data.string.x, s);
+  mpc_set_build(p->data.string.set, s, 0);
   return mpc_expectf(p, "one of '%s'", s);
 }
 
@@ -1772,6 +2490,7 @@ mpc_parser_t *mpc_noneof(const char *s) {
   p->type = MPC_TYPE_NONEOF;
   p->data.string.x = malloc(strlen(s) + 1);
   strcpy(p->data.string.x, s);
+  mpc_set_build(p->data.string.set, s, 1);
   return mpc_expectf(p, "none of '%s'", s);
 
 }
@@ -1935,6 +2654,7 @@ mpc_parser_t *mpc_or(int n, ...) {
   p->type = MPC_TYPE_OR;
   p->data.or.n = n;
   p->data.or.xs = malloc(sizeof(mpc_parser_t*) * n);
+  p->data.or.jump = NULL;
 
   va_start(va, n);
   for (i = 0; i < n; i++) {
@@ -2776,6 +3496,7 @@ static void mpc_print_unretained(mpc_parser_t *p, int force) {
   if (p->type == MPC_TYPE_MANY)  { mpc_print_unretained(p->data.repeat.x, 0); printf("*"); }
   if (p->type == MPC_TYPE_MANY1) { mpc_print_unretained(p->data.repeat.x, 0); printf("+"); }
   if (p->type == MPC_TYPE_COUNT) { mpc_print_unretained(p->data.repeat.x, 0); printf("{%i}", p->data.repeat.n); }
+  if (p->type == MPC_TYPE_SCAN)  { mpc_print_unretained(p->data.scan.x, 0); printf("%s", p->data.scan.n ? "+" : "*"); }
 
   if (p->type == MPC_TYPE_OR) {
     printf("(");
@@ -2879,28 +3600,309 @@ int mpc_test_pass(mpc_parser_t *p, const char *s, const void *d,
 }
 
 
+/*
+** AST Arenas
+**
+** An arena holds the nodes, contents and children
+** of a whole parse, and interns their tags so that
+** each node keeps only an id and a pointer to one
+** shared copy. Deleting the root frees the whole
+** arena at once and deleting any other of its
+** nodes does nothing.
+*/
+
+enum {
+  MPC_ARENA_BLOCK    = 65536,
+  MPC_ARENA_KEYS_MIN = 64
+};
+
+enum {
+  MPC_ARENA_TAG          = 0,
+  MPC_ARENA_ADD_TAG      = 1,
+  MPC_ARENA_ADD_ROOT_TAG = 2
+};
+
+typedef union {
+  long l;
+  double d;
+  void *p;
+} mpc_arena_align_t;
+
+typedef struct {
+  const char *t;
+  int tag_id;
+  int op;
+  int id;
+  unsigned long hash;
+} mpc_arena_key_t;
+
+struct mpc_arena_t {
+  mpc_arena_align_t *blocks;
+  char *next;
+  size_t left;
+  int tags_num;
+  int tags_slots;
+  char **tags;
+  int keys_num;
+  int keys_slots;
+  mpc_arena_key_t *keys;
+  mpc_ast_t *root;
+};
+
+mpc_arena_t *mpc_arena_new(void) {
+  mpc_arena_t *m = malloc(sizeof(mpc_arena_t));
+  m->blocks = NULL;
+  m->next = NULL;
+  m->left = 0;
+  m->tags_num = 0;
+  m->tags_slots = 0;
+  m->tags = NULL;
+  m->keys_num = 0;
+  m->keys_slots = MPC_ARENA_KEYS_MIN;
+  m->keys = calloc(m->keys_slots, sizeof(mpc_arena_key_t));
+  m->root = NULL;
+  return m;
+}
+
+static void mpc_arena_delete(mpc_arena_t *m) {
+  mpc_arena_align_t *b;
+  while (m->blocks) {
+    b = m->blocks;
+    m->blocks = b->p;
+    free(b);
+  }
+  free(m->tags);
+  free(m->keys);
+  free(m);
+}
+
+static void *mpc_arena_alloc(mpc_arena_t *m, size_t n) {
+
+  mpc_arena_align_t *b;
+  size_t size;
+  char *x;
+
+  n = (n + sizeof(mpc_arena_align_t) - 1) / sizeof(mpc_arena_align_t) * sizeof(mpc_arena_align_t);
+
+  if (n > m->left) {
+    size = n > MPC_ARENA_BLOCK / 4 ? n : MPC_ARENA_BLOCK;
+    b = malloc(sizeof(mpc_arena_align_t) + size);
+    b->p = m->blocks;
+    m->blocks = b;
+    if (size == n) { return b + 1; }
+    m->next = (char*)(b + 1);
+    m->left = size;
+  }
+
+  x = m->next;
+  m->next += n;
+  m->left -= n;
+  return x;
+}
+
+static char *mpc_arena_strdup(mpc_arena_t *m, const char *s) {
+  size_t n = strlen(s) + 1;
+  return memcpy(mpc_arena_alloc(m, n), s, n);
+}
+
+static unsigned long mpc_arena_hash(const char *t, int tag_id, int op) {
+  unsigned long h = 2166136261UL;
+  while (*t) { h = (h ^ (unsigned char)*t++) * 16777619UL; }
+  h = (h ^ (unsigned long)tag_id) * 16777619UL;
+  h = (h ^ (unsigned long)op) * 16777619UL;
+  return h;
+}
+
+static mpc_arena_key_t *mpc_arena_key(mpc_arena_key_t *keys, int slots, unsigned long hash) {
+  size_t j = hash & (slots - 1);
+  while (keys[j].t) { j = (j + 1) & (slots - 1); }
+  return &keys[j];
+}
+
+/*
+** Gives the id of the tag made by applying one of
+** the tag operations to tag `tag_id`. Results are
+** cached by their arguments, so after the first few
+** nodes of a parse no tag strings are built at all.
+*/
+
+static int mpc_arena_tag_id(mpc_arena_t *m, const char *t, int tag_id, int op) {
+
+  int i, id;
+  unsigned long hash = mpc_arena_hash(t, tag_id, op);
+  size_t j = hash & (m->keys_slots - 1);
+  const char *old = tag_id < 0 ? "" : m->tags[tag_id];
+  mpc_arena_key_t *keys, *k;
+  size_t l;
+  char *s;
+
+  for (k = &m->keys[j]; k->t; k = &m->keys[j]) {
+    if (k->hash == hash && k->tag_id == tag_id && k->op == op && strcmp(k->t, t) == 0) {
+      return k->id;
+    }
+    j = (j + 1) & (m->keys_slots - 1);
+  }
+
+  l = strlen(t);
+  switch (op) {
+    case MPC_ARENA_ADD_TAG:
+      s = mpc_arena_alloc(m, l + 1 + strlen(old) + 1);
+      memcpy(s, t, l);
+      s[l] = '|';
+      strcpy(s + l + 1, old);
+      break;
+    case MPC_ARENA_ADD_ROOT_TAG:
+      s = mpc_arena_alloc(m, (l-1) + strlen(old) + 1);
+      memcpy(s, t, l-1);
+      strcpy(s + (l-1), old);
+      break;
+    default:
+      s = mpc_arena_strdup(m, t);
+      break;
+  }
+
+  for (id = 0; id < m->tags_num; id++) {
+    if (strcmp(m->tags[id], s) == 0) { break; }
+  }
+
+  if (id == m->tags_num) {
+    if (m->tags_num == m->tags_slots) {
+      m->tags_slots = m->tags_slots ? m->tags_slots * 2 : 16;
+      m->tags = realloc(m->tags, sizeof(char*) * m->tags_slots);
+    }
+    m->tags[m->tags_num++] = s;
+  }
+
+  k->t = mpc_arena_strdup(m, t);
+  k->tag_id = tag_id;
+  k->op = op;
+  k->id = id;
+  k->hash = hash;
+  m->keys_num++;
+
+  if (m->keys_num * 2 > m->keys_slots) {
+    keys = calloc(m->keys_slots * 2, sizeof(mpc_arena_key_t));
+    for (i = 0; i < m->keys_slots; i++) {
+      if (m->keys[i].t) { *mpc_arena_key(keys, m->keys_slots * 2, m->keys[i].hash) = m->keys[i]; }
+    }
+    free(m->keys);
+    m->keys = keys;
+    m->keys_slots *= 2;
+  }
+
+  return id;
+}
+
+static mpc_ast_t *mpc_arena_tag(mpc_ast_t *a, const char *t, int op) {
+  a->tag_id = mpc_arena_tag_id(a->arena, t, op == MPC_ARENA_TAG ? -1 : a->tag_id, op);
+  a->tag = a->arena->tags[a->tag_id];
+  return a;
+}
+
+mpc_ast_t *mpc_arena_ast_new(mpc_arena_t *m, const char *tag, const char *contents) {
+
+  mpc_ast_t *a = mpc_arena_alloc(m, sizeof(mpc_ast_t));
+
+  a->arena = m;
+  a->tag_id = mpc_arena_tag_id(m, tag, -1, MPC_ARENA_TAG);
+  a->tag = m->tags[a->tag_id];
+  a->contents = mpc_arena_strdup(m, contents);
+  a->state = mpc_state_new();
+  a->children_num = 0;
+  a->children = NULL;
+  return a;
+
+}
+
+/*
+** Children arrays grow by doubling, so their size is
+** kept implicitly as the next power of two.
+*/
+
+static mpc_ast_t *mpc_arena_add_child(mpc_ast_t *r, mpc_ast_t *a) {
+
+  int n = r->children_num;
+  mpc_ast_t **cs;
+
+  if ((n & (n - 1)) == 0) {
+    cs = mpc_arena_alloc(r->arena, sizeof(mpc_ast_t*) * (n ? n * 2 : 1));
+    if (n) { memcpy(cs, r->children, sizeof(mpc_ast_t*) * n); }
+    r->children = cs;
+  }
+
+  r->children[r->children_num++] = a;
+  return r;
+}
+
+/*
+** Hands the arena over to the root of a finished
+** parse. If the parse failed nothing in the arena
+** is still in use and it is deleted straight away.
+*/
+
+void mpc_arena_done(mpc_arena_t *m, mpc_ast_t *a) {
+  if (a && a->arena == m) {
+    m->root = a;
+  } else {
+    mpc_arena_delete(m);
+  }
+}
+
 /*
 ** AST
 */
 
+/*
+** Deletes with a stack of its own rather than by
+** recursion, as an AST can be nested as deeply as
+** the parser allows.
+*/
+
 void mpc_ast_delete(mpc_ast_t *a) {
 
-  int i;
+  int i, n = 0, m = 16;
+  mpc_ast_t **stk;
 
   if (a == NULL) { return; }
 
-  for (i = 0; i < a->children_num; i++) {
-    mpc_ast_delete(a->children[i]);
+  if (a->arena) {
+    if (a->arena->root == a) { mpc_arena_delete(a->arena); }
+    return;
   }
 
-  free(a->children);
-  free(a->tag);
-  free(a->contents);
-  free(a);
+  stk = malloc(sizeof(mpc_ast_t*) * m);
+  stk[n++] = a;
+
+  while (n) {
+
+    a = stk[--n];
+
+    if (a->arena) {
+      if (a->arena->root == a) { mpc_arena_delete(a->arena); }
+      continue;
+    }
+
+    if (n + a->children_num > m) {
+      m = (n + a->children_num) * 2;
+      stk = realloc(stk, sizeof(mpc_ast_t*) * m);
+    }
+
+    for (i = 0; i < a->children_num; i++) {
+      stk[n++] = a->children[i];
+    }
+
+    free(a->children);
+    free(a->tag);
+    free(a->contents);
+    free(a);
+  }
+
+  free(stk);
 
 }
 
 static void mpc_ast_delete_no_children(mpc_ast_t *a) {
+  if (a->arena) { return; }
   free(a->children);
   free(a->tag);
   free(a->contents);
@@ -2921,6 +3923,8 @@ mpc_ast_t *mpc_ast_new(const char *tag, const char *contents) {
 
   a->children_num = 0;
   a->children = NULL;
+  a->tag_id = -1;
+  a->arena = NULL;
   return a;
 
 }
@@ -2951,7 +3955,7 @@ mpc_ast_t *mpc_ast_add_root(mpc_ast_t *a) {
   if (a->children_num == 0) { return a; }
   if (a->children_num == 1) { return a; }
 
-  r = mpc_ast_new(">", "");
+  r = a->arena ? mpc_arena_ast_new(a->arena, ">", "") : mpc_ast_new(">", "");
   mpc_ast_add_child(r, a);
   return r;
 }
@@ -2972,6 +3976,7 @@ int mpc_ast_eq(mpc_ast_t *a, mpc_ast_t *b) {
 }
 
 mpc_ast_t *mpc_ast_add_child(mpc_ast_t *r, mpc_ast_t *a) {
+  if (r->arena) { return mpc_arena_add_child(r, a); }
   r->children_num++;
   r->children = realloc(r->children, sizeof(mpc_ast_t*) * r->children_num);
   r->children[r->children_num-1] = a;
@@ -2980,6 +3985,7 @@ mpc_ast_t *mpc_ast_add_child(mpc_ast_t *r, mpc_ast_t *a) {
 
 mpc_ast_t *mpc_ast_add_tag(mpc_ast_t *a, const char *t) {
   if (a == NULL) { return a; }
+  if (a->arena) { return mpc_arena_tag(a, t, MPC_ARENA_ADD_TAG); }
   a->tag = realloc(a->tag, strlen(t) + 1 + strlen(a->tag) + 1);
   memmove(a->tag + strlen(t) + 1, a->tag, strlen(a->tag)+1);
   memmove(a->tag, t, strlen(t));
@@ -2989,6 +3995,7 @@ mpc_ast_t *mpc_ast_add_tag(mpc_ast_t *a, const char *t) {
 
 mpc_ast_t *mpc_ast_add_root_tag(mpc_ast_t *a, const char *t) {
   if (a == NULL) { return a; }
+  if (a->arena) { return mpc_arena_tag(a, t, MPC_ARENA_ADD_ROOT_TAG); }
   a->tag = realloc(a->tag, (strlen(t)-1) + strlen(a->tag) + 1);
   memmove(a->tag + (strlen(t)-1), a->tag, strlen(a->tag)+1);
   memmove(a->tag, t, (strlen(t)-1));
@@ -2996,6 +4003,7 @@ mpc_ast_t *mpc_ast_add_root_tag(mpc_ast_t *a, const char *t) {
 }
 
 mpc_ast_t *mpc_ast_tag(mpc_ast_t *a, const char *t) {
+  if (a->arena) { return mpc_arena_tag(a, t, MPC_ARENA_TAG); }
   a->tag = realloc(a->tag, strlen(t) + 1);
   strcpy(a->tag, t);
   return a;
@@ -3213,6 +4221,7 @@ mpc_val_t *mpcf_fold_ast(int n, mpc_val_t **xs) {
 
   int i, j;
   mpc_ast_t** as = (mpc_ast_t**)xs;
+  mpc_arena_t *m = NULL;
   mpc_ast_t *r;
 
   if (n == 0) { return NULL; }
@@ -3220,7 +4229,11 @@ mpc_val_t *mpcf_fold_ast(int n, mpc_val_t **xs) {
   if (n == 2 && xs[1] == NULL) { return xs[0]; }
   if (n == 2 && xs[0] == NULL) { return xs[1]; }
 
-  r = mpc_ast_new(">", "");
+  for (i = 0; i < n; i++) {
+    if (as[i]) { m = as[i]->arena; break; }
+  }
+
+  r = m ? mpc_arena_ast_new(m, ">", "") : mpc_ast_new(">", "");
 
   for (i = 0; i < n; i++) {
 
@@ -3294,6 +4307,7 @@ mpc_parser_t *mpca_or(int n, ...) {
   p->type = MPC_TYPE_OR;
   p->data.or.n = n;
   p->data.or.xs = malloc(sizeof(mpc_parser_t*) * n);
+  p->data.or.jump = NULL;
 
   va_start(va, n);
   for (i = 0; i < n; i++) {
@@ -3608,6 +4622,8 @@ typedef struct {
   mpc_parser_t *grammar;
 } mpca_stmt_t;
 
+static void mpc_predict(mpc_parser_t *p);
+
 static mpc_val_t *mpca_stmt_afold(int n, mpc_val_t **xs) {
   mpca_stmt_t *stmt = malloc(sizeof(mpca_stmt_t));
   stmt->ident = ((char**)xs)[0];
@@ -3651,24 +4667,34 @@ static void mpca_stmt_list_delete(mpc_val_t *x) {
 
 static mpc_val_t *mpca_stmt_list_apply_to(mpc_val_t *x, void *s) {
 
+  int j, n = 0;
   mpca_grammar_st_t *st = s;
   mpca_stmt_t *stmt;
   mpca_stmt_t **stmts = x;
-  mpc_parser_t *left;
+  mpc_parser_t *left, **lefts;
 
-  while(*stmts) {
-    stmt = *stmts;
+  while(stmts[n]) { n++; }
+  lefts = malloc(sizeof(mpc_parser_t*) * (n+1));
+
+  for (j = 0; j < n; j++) {
+    stmt = stmts[j];
     left = mpca_grammar_find_parser(stmt->ident, st);
     if (st->flags & MPCA_LANG_PREDICTIVE) { stmt->grammar = mpc_predictive(stmt->grammar); }
     if (stmt->name) { stmt->grammar = mpc_expect(stmt->grammar, stmt->name); }
     mpc_optimise(stmt->grammar);
     mpc_define(left, stmt->grammar);
+    lefts[j] = left;
     free(stmt->ident);
     free(stmt->name);
     free(stmt);
-    stmts++;
   }
 
+  /* Rules may refer to ones defined after them so predict once all are known */
+  for (j = 0; j < n; j++) {
+    if (lefts[j]->type != MPC_TYPE_UNDEFINED && !lefts[j]->frozen) { mpc_predict(lefts[j]); }
+  }
+
+  free(lefts);
   free(x);
 
   return NULL;
@@ -3865,6 +4891,7 @@ static int mpc_nodecount_unretained(mpc_parser_t* p, int force) {
   if (p->type == MPC_TYPE_MANY)  { return 1 + mpc_nodecount_unretained(p->data.repeat.x, 0); }
   if (p->type == MPC_TYPE_MANY1) { return 1 + mpc_nodecount_unretained(p->data.repeat.x, 0); }
   if (p->type == MPC_TYPE_COUNT) { return 1 + mpc_nodecount_unretained(p->data.repeat.x, 0); }
+  if (p->type == MPC_TYPE_SCAN)  { return 1 + mpc_nodecount_unretained(p->data.scan.x, 0); }
 
   if (p->type == MPC_TYPE_OR) {
     total = 1;
@@ -3892,6 +4919,24 @@ void mpc_stats(mpc_parser_t* p) {
   printf("Node Count: %i\n", mpc_nodecount_unretained(p, 1));
 }
 
+static int mpc_optimise_is_class(mpc_parser_t *p) {
+  while (!p->retained && p->type == MPC_TYPE_EXPECT) { p = p->data.expect.x; }
+  return !p->retained && (p->type == MPC_TYPE_ONEOF || p->type == MPC_TYPE_NONEOF);
+}
+
+static const unsigned char *mpc_optimise_class_set(mpc_parser_t *p) {
+  while (p->type == MPC_TYPE_EXPECT) { p = p->data.expect.x; }
+  return p->data.string.set;
+}
+
+static void mpc_optimise_scan(mpc_parser_t *p, mpc_parser_t *x, int n, const unsigned char *run) {
+  p->type = MPC_TYPE_SCAN;
+  p->data.scan.n = n;
+  p->data.scan.x = x;
+  p->data.scan.s = malloc(sizeof(mpc_scan_t));
+  mpc_scan_build(p->data.scan.s, run);
+}
+
 static void mpc_optimise_unretained(mpc_parser_t *p, int force) {
 
   int i, n, m;
@@ -3912,6 +4957,7 @@ static void mpc_optimise_unretained(mpc_parser_t *p, int force) {
   if (p->type == MPC_TYPE_MANY)       { mpc_optimise_unretained(p->data.repeat.x, 0); }
   if (p->type == MPC_TYPE_MANY1)      { mpc_optimise_unretained(p->data.repeat.x, 0); }
   if (p->type == MPC_TYPE_COUNT)      { mpc_optimise_unretained(p->data.repeat.x, 0); }
+  if (p->type == MPC_TYPE_SCAN)       { mpc_optimise_unretained(p->data.scan.x, 0); }
 
   if (p->type == MPC_TYPE_OR) {
     for(i = 0; i < p->data.or.n; i++) {
@@ -3938,7 +4984,8 @@ static void mpc_optimise_unretained(mpc_parser_t *p, int force) {
       p->data.or.n = n + m - 1;
       p->data.or.xs = realloc(p->data.or.xs, sizeof(mpc_parser_t*) * (n + m -1));
       memmove(p->data.or.xs + n - 1, t->data.or.xs, m * sizeof(mpc_parser_t*));
-      free(t->data.or.xs); free(t->name); free(t);
+      free(p->data.or.jump); p->data.or.jump = NULL;
+      free(t->data.or.xs); free(t->data.or.jump); free(t->name); free(t);
       continue;
     }
 
@@ -3952,7 +4999,8 @@ static void mpc_optimise_unretained(mpc_parser_t *p, int force) {
       p->data.or.xs = realloc(p->data.or.xs, sizeof(mpc_parser_t*) * (n + m -1));
       memmove(p->data.or.xs + m, p->data.or.xs + 1, (n - 1) * sizeof(mpc_parser_t*));
       memmove(p->data.or.xs, t->data.or.xs, m * sizeof(mpc_parser_t*));
-      free(t->data.or.xs); free(t->name); free(t);
+      free(p->data.or.jump); p->data.or.jump = NULL;
+      free(t->data.or.xs); free(t->data.or.jump); free(t->name); free(t);
       continue;
     }
 
@@ -4055,13 +5103,1667 @@ static void mpc_optimise_unretained(mpc_parser_t *p, int force) {
       continue;
     }
 
+    /* Fuse `many` of a character class into a scan */
+    if ((p->type == MPC_TYPE_MANY || p->type == MPC_TYPE_MANY1)
+    &&  p->data.repeat.f == mpcf_strfold
+    &&  mpc_optimise_is_class(p->data.repeat.x)) {
+      t = p->data.repeat.x;
+      mpc_optimise_scan(p, t, p->type == MPC_TYPE_MANY1 ? 1 : 0, mpc_optimise_class_set(t));
+      continue;
+    }
+
     return;
 
   }
 
 }
 
-void mpc_optimise(mpc_parser_t *p) {
-  mpc_optimise_unretained(p, 1);
+/*
+** Prediction
+*/
+
+/*
+** After the structural optimisations `mpc_optimise`
+** works out, for every parser reachable from the one
+** given, the set of bytes that can start a match
+** (its FIRST set) and whether it can succeed without
+** consuming any input at all (nullable).
+**
+** Because grammars are recursive this is done by
+** starting from empty sets and recomputing every
+** node until nothing changes any more.
+**
+** Each `or` parser then gets a 256 entry jump table
+** mapping the next byte to the only alternative that
+** could possibly match it. Alternatives which are
+** nullable can match anything so they are never the
+** target of a jump. Parsers still undefined at this
+** point are assumed to match anything too, so it is
+** always safe, if less useful, to optimise a grammar
+** before all of it has been defined.
+*/
+
+typedef struct {
+  mpc_parser_t *p;
+  unsigned char first[MPC_SET_SIZE];
+  int nullable;
+} mpc_first_t;
+
+static int mpc_first_cmp(const void *a, const void *b) {
+  const mpc_parser_t *x = ((const mpc_first_t*)a)->p;
+  const mpc_parser_t *y = ((const mpc_first_t*)b)->p;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static mpc_first_t *mpc_first_find(mpc_first_t *fs, int n, mpc_parser_t *p) {
+  mpc_first_t k;
+  k.p = p;
+  return bsearch(&k, fs, n, sizeof(mpc_first_t), mpc_first_cmp);
+}
+
+static void mpc_first_add_all(mpc_first_t *f) {
+  int c;
+  for (c = 1; c < 256; c++) { mpc_set_add(f->first, c); }
+}
+
+static void mpc_first_union(mpc_first_t *f, const unsigned char *set) {
+  int j;
+  for (j = 0; j < MPC_SET_SIZE; j++) { f->first[j] |= set[j]; }
+}
+
+static int mpc_first_children(mpc_parser_t *p, mpc_parser_t ***xs) {
+  switch (p->type) {
+    case MPC_TYPE_EXPECT:     *xs = &p->data.expect.x;     return 1;
+    case MPC_TYPE_APPLY:      *xs = &p->data.apply.x;      return 1;
+    case MPC_TYPE_APPLY_TO:   *xs = &p->data.apply_to.x;   return 1;
+    case MPC_TYPE_CHECK:      *xs = &p->data.check.x;      return 1;
+    case MPC_TYPE_CHECK_WITH: *xs = &p->data.check_with.x; return 1;
+    case MPC_TYPE_PREDICT:    *xs = &p->data.predict.x;    return 1;
+    case MPC_TYPE_NOT:
+    case MPC_TYPE_MAYBE:      *xs = &p->data.not.x;        return 1;
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+    case MPC_TYPE_COUNT:      *xs = &p->data.repeat.x;     return 1;
+    case MPC_TYPE_SCAN:       *xs = &p->data.scan.x;       return 1;
+    case MPC_TYPE_OR:         *xs = p->data.or.xs;         return p->data.or.n;
+    case MPC_TYPE_AND:        *xs = p->data.and.xs;        return p->data.and.n;
+    default:                  *xs = NULL;                  return 0;
+  }
+}
+
+static void mpc_first_collect(mpc_parser_t *p, mpc_first_t **fs, int *n, int *slots) {
+
+  int j, m;
+  mpc_parser_t **xs;
+
+  for (j = 0; j < *n; j++) {
+    if ((*fs)[j].p == p) { return; }
+  }
+
+  if (*n == *slots) {
+    *slots = *slots ? *slots * 2 : 64;
+    *fs = realloc(*fs, sizeof(mpc_first_t) * (*slots));
+  }
+
+  (*fs)[*n].p = p;
+  (*n)++;
+
+  m = mpc_first_children(p, &xs);
+  for (j = 0; j < m; j++) { mpc_first_collect(xs[j], fs, n, slots); }
 }
 
+static int mpc_first_update(mpc_first_t *fs, int n, mpc_first_t *f) {
+
+  int j, c, m;
+  mpc_first_t g, *x;
+  mpc_parser_t *p = f->p, **xs;
+
+  memset(&g, 0, sizeof(mpc_first_t));
+
+  switch (p->type) {
+
+    case MPC_TYPE_UNDEFINED:
+      mpc_first_add_all(&g);
+      g.nullable = 1;
+      break;
+
+    case MPC_TYPE_PASS:
+    case MPC_TYPE_LIFT:
+    case MPC_TYPE_LIFT_VAL:
+    case MPC_TYPE_STATE:
+    case MPC_TYPE_ANCHOR:
+    case MPC_TYPE_SOI:
+    case MPC_TYPE_EOI:
+    case MPC_TYPE_NOT:
+      g.nullable = 1;
+      break;
+
+    case MPC_TYPE_ANY:
+    case MPC_TYPE_SATISFY:
+      mpc_first_add_all(&g);
+      break;
+
+    case MPC_TYPE_SINGLE:
+      if (p->data.single.x) { mpc_set_add(g.first, p->data.single.x); }
+      break;
+
+    case MPC_TYPE_RANGE:
+      for (c = 1; c < 256; c++) {
+        if ((char)c >= p->data.range.x && (char)c <= p->data.range.y) { mpc_set_add(g.first, c); }
+      }
+      break;
+
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+      mpc_first_union(&g, p->data.string.set);
+      break;
+
+    case MPC_TYPE_STRING:
+      if (p->data.string.x[0]) { mpc_set_add(g.first, p->data.string.x[0]); }
+      else { g.nullable = 1; }
+      break;
+
+    case MPC_TYPE_AND:
+      g.nullable = 1;
+      m = mpc_first_children(p, &xs);
+      for (j = 0; j < m && g.nullable; j++) {
+        x = mpc_first_find(fs, n, xs[j]);
+        mpc_first_union(&g, x->first);
+        g.nullable = x->nullable;
+      }
+      break;
+
+    default:
+      m = mpc_first_children(p, &xs);
+      for (j = 0; j < m; j++) {
+        x = mpc_first_find(fs, n, xs[j]);
+        mpc_first_union(&g, x->first);
+        g.nullable = g.nullable || x->nullable;
+      }
+      if (p->type == MPC_TYPE_MAYBE
+      ||  p->type == MPC_TYPE_MANY
+      || (p->type == MPC_TYPE_COUNT && p->data.repeat.n == 0)
+      || (p->type == MPC_TYPE_SCAN && p->data.scan.n == 0)) {
+        g.nullable = 1;
+      }
+      break;
+  }
+
+  if (memcmp(g.first, f->first, MPC_SET_SIZE) == 0 && g.nullable == f->nullable) { return 0; }
+
+  memcpy(f->first, g.first, MPC_SET_SIZE);
+  f->nullable = g.nullable;
+  return 1;
+}
+
+static void mpc_predict_or(mpc_parser_t *p, mpc_first_t *fs, int n) {
+
+  int c, j, k;
+  int useful = 0;
+  mpc_first_t *x;
+  unsigned char *jump;
+
+  free(p->data.or.jump);
+  p->data.or.jump = NULL;
+
+  if (p->data.or.n >= MPC_JUMP_MANY) { return; }
+
+  jump = malloc(MPC_JUMP_SIZE);
+
+  for (c = 0; c < MPC_JUMP_SIZE; c++) {
+    k = MPC_JUMP_NONE;
+    for (j = 0; j < p->data.or.n; j++) {
+      x = mpc_first_find(fs, n, p->data.or.xs[j]);
+      if (x->nullable) { k = MPC_JUMP_MANY; break; }
+      if (!mpc_set_has(x->first, c)) { continue; }
+      if (k != MPC_JUMP_NONE) { k = MPC_JUMP_MANY; break; }
+      k = j + 1;
+    }
+    jump[c] = k;
+    useful = useful || (k != MPC_JUMP_NONE && k != MPC_JUMP_MANY);
+  }
+
+  if (useful) { p->data.or.jump = jump; } else { free(jump); }
+}
+
+/*
+** In a `many` of an `or` a character accepted by
+** a class alternative, and which cannot start any
+** alternative before it, is always consumed alone
+** by that class. Runs of such characters can then
+** be scanned directly and the `or` run only on the
+** characters which end them.
+*/
+
+static int mpc_predict_run(mpc_parser_t *x, mpc_first_t *fs, int n, unsigned char *run) {
+
+  int j, k;
+  mpc_first_t *f;
+
+  if (x->type != MPC_TYPE_OR || x->retained) { return 0; }
+
+  for (j = 0; j < x->data.or.n; j++) {
+    if (mpc_optimise_is_class(x->data.or.xs[j])) { break; }
+  }
+  if (j == x->data.or.n) { return 0; }
+
+  memcpy(run, mpc_optimise_class_set(x->data.or.xs[j]), MPC_SET_SIZE);
+
+  while (j--) {
+    f = mpc_first_find(fs, n, x->data.or.xs[j]);
+    if (f->nullable) { return 0; }
+    for (k = 0; k < MPC_SET_SIZE; k++) { run[k] &= ~f->first[k]; }
+  }
+
+  for (k = 0; k < MPC_SET_SIZE; k++) {
+    if (run[k]) { return 1; }
+  }
+  return 0;
+}
+
+static void mpc_predict_scan(mpc_parser_t *p, mpc_first_t *fs, int n) {
+
+  unsigned char run[MPC_SET_SIZE];
+
+  if ((p->type == MPC_TYPE_MANY || p->type == MPC_TYPE_MANY1)
+  &&  p->data.repeat.f == mpcf_strfold
+  &&  mpc_predict_run(p->data.repeat.x, fs, n, run)) {
+    mpc_optimise_scan(p, p->data.repeat.x, p->type == MPC_TYPE_MANY1 ? 1 : 0, run);
+  }
+
+  if (p->type == MPC_TYPE_SCAN && !mpc_scan_is_class(p->data.scan.x)) {
+    if (!mpc_predict_run(p->data.scan.x, fs, n, run)) {
+      memset(run, 0, MPC_SET_SIZE);
+    }
+    mpc_scan_build(p->data.scan.s, run);
+  }
+}
+
+static void mpc_predict_unretained(mpc_parser_t *p, mpc_first_t *fs, int n, int force) {
+
+  int j, m;
+  mpc_parser_t **xs;
+
+  if (p->retained && !force) { return; }
+
+  m = mpc_first_children(p, &xs);
+  for (j = 0; j < m; j++) { mpc_predict_unretained(xs[j], fs, n, 0); }
+
+  if (p->type == MPC_TYPE_OR) { mpc_predict_or(p, fs, n); }
+  mpc_predict_scan(p, fs, n);
+}
+
+static void mpc_predict(mpc_parser_t *p) {
+
+  int j, changed;
+  int n = 0, slots = 0;
+  mpc_first_t *fs = NULL;
+
+  mpc_first_collect(p, &fs, &n, &slots);
+  qsort(fs, n, sizeof(mpc_first_t), mpc_first_cmp);
+
+  for (j = 0; j < n; j++) {
+    memset(fs[j].first, 0, MPC_SET_SIZE);
+    fs[j].nullable = 0;
+  }
+
+  do {
+    changed = 0;
+    for (j = 0; j < n; j++) { changed |= mpc_first_update(fs, n, &fs[j]); }
+  } while (changed);
+
+  mpc_predict_unretained(p, fs, n, 1);
+
+  free(fs);
+}
+
+void mpc_optimise(mpc_parser_t *p) {
+  if (p->frozen) { return; }
+  mpc_optimise_unretained(p, 1);
+  mpc_predict(p);
+}
+
+/*
+** Freezing marks every parser `p` runs, retained
+** or not, so that none of them can be changed.
+*/
+
+void mpc_freeze(mpc_parser_t *p) {
+
+  int j, m;
+  mpc_parser_t **xs;
+
+  if (p->frozen) { return; }
+  p->frozen = 1;
+
+  m = mpc_first_children(p, &xs);
+  for (j = 0; j < m; j++) { mpc_freeze(xs[j]); }
+}
+
+/*
+** Grammar Tables
+*/
+
+/*
+** A grammar table is a snapshot of defined and
+** optimised parsers which can be loaded again
+** without running the grammar parser. Each node
+** reachable from the given parsers is written in
+** turn, referring to other nodes by index, and
+** functions are written as indices into a list
+** of those grammars are built from. Parsers using
+** any other functions or data cannot be written.
+*/
+
+typedef void (*mpc_table_fn_t)(void);
+
+/*
+** Names are given for the public functions so
+** generated parsers can call them directly.
+*/
+
+static const struct { mpc_table_fn_t f; const char *name; } mpc_table_fns[] = {
+  { NULL, "NULL" },
+  { (mpc_table_fn_t)free, "free" },
+  { (mpc_table_fn_t)mpcf_dtor_null, "mpcf_dtor_null" },
+  { (mpc_table_fn_t)mpcf_ctor_null, "mpcf_ctor_null" },
+  { (mpc_table_fn_t)mpcf_ctor_str, "mpcf_ctor_str" },
+  { (mpc_table_fn_t)mpcf_free, "mpcf_free" },
+  { (mpc_table_fn_t)mpcf_int, "mpcf_int" },
+  { (mpc_table_fn_t)mpcf_hex, "mpcf_hex" },
+  { (mpc_table_fn_t)mpcf_oct, "mpcf_oct" },
+  { (mpc_table_fn_t)mpcf_float, "mpcf_float" },
+  { (mpc_table_fn_t)mpcf_strtriml, "mpcf_strtriml" },
+  { (mpc_table_fn_t)mpcf_strtrimr, "mpcf_strtrimr" },
+  { (mpc_table_fn_t)mpcf_strtrim, "mpcf_strtrim" },
+  { (mpc_table_fn_t)mpcf_escape, "mpcf_escape" },
+  { (mpc_table_fn_t)mpcf_escape_regex, "mpcf_escape_regex" },
+  { (mpc_table_fn_t)mpcf_escape_string_raw, "mpcf_escape_string_raw" },
+  { (mpc_table_fn_t)mpcf_escape_char_raw, "mpcf_escape_char_raw" },
+  { (mpc_table_fn_t)mpcf_unescape, "mpcf_unescape" },
+  { (mpc_table_fn_t)mpcf_unescape_regex, "mpcf_unescape_regex" },
+  { (mpc_table_fn_t)mpcf_unescape_string_raw, "mpcf_unescape_string_raw" },
+  { (mpc_table_fn_t)mpcf_unescape_char_raw, "mpcf_unescape_char_raw" },
+  { (mpc_table_fn_t)mpcf_null, "mpcf_null" },
+  { (mpc_table_fn_t)mpcf_fst, "mpcf_fst" },
+  { (mpc_table_fn_t)mpcf_snd, "mpcf_snd" },
+  { (mpc_table_fn_t)mpcf_trd, "mpcf_trd" },
+  { (mpc_table_fn_t)mpcf_fst_free, "mpcf_fst_free" },
+  { (mpc_table_fn_t)mpcf_snd_free, "mpcf_snd_free" },
+  { (mpc_table_fn_t)mpcf_trd_free, "mpcf_trd_free" },
+  { (mpc_table_fn_t)mpcf_all_free, "mpcf_all_free" },
+  { (mpc_table_fn_t)mpcf_strfold, "mpcf_strfold" },
+  { (mpc_table_fn_t)mpcf_maths, "mpcf_maths" },
+  { (mpc_table_fn_t)mpcf_fold_ast, "mpcf_fold_ast" },
+  { (mpc_table_fn_t)mpcf_str_ast, "mpcf_str_ast" },
+  { (mpc_table_fn_t)mpcf_state_ast, "mpcf_state_ast" },
+  { (mpc_table_fn_t)mpc_ast_delete, "mpc_ast_delete" },
+  { (mpc_table_fn_t)mpc_ast_tag, "mpc_ast_tag" },
+  { (mpc_table_fn_t)mpc_ast_add_tag, "mpc_ast_add_tag" },
+  { (mpc_table_fn_t)mpc_ast_add_root, "mpc_ast_add_root" },
+  { (mpc_table_fn_t)mpc_ast_add_root_tag, "mpc_ast_add_root_tag" },
+  { (mpc_table_fn_t)mpc_soft_delete, NULL },
+  { (mpc_table_fn_t)mpc_boundary_anchor, NULL },
+  { (mpc_table_fn_t)mpc_boundary_newline_anchor, NULL }
+};
+
+static const char *mpc_table_tags[] = { "string", "char", "regex" };
+
+enum {
+  MPC_TABLE_FNS  = sizeof(mpc_table_fns) / sizeof(mpc_table_fns[0]),
+  MPC_TABLE_TAGS = sizeof(mpc_table_tags) / sizeof(mpc_table_tags[0])
+};
+
+/* The data of an `apply_to` or `check_with` */
+enum {
+  MPC_TABLE_DATA_NONE = 0,
+  MPC_TABLE_DATA_NAME = 1,
+  MPC_TABLE_DATA_TAG  = 2
+};
+
+static const char mpc_table_magic[4] = { 'm', 'p', 'c', 1 };
+
+typedef struct {
+  unsigned char *s;
+  size_t n, m;
+  int nodes_num, nodes_slots;
+  mpc_parser_t **nodes;
+  const char *bad;
+} mpc_table_out_t;
+
+static void mpc_table_put(mpc_table_out_t *t, int c) {
+  if (t->n == t->m) {
+    t->m = t->m ? t->m * 2 : 256;
+    t->s = realloc(t->s, t->m);
+  }
+  t->s[t->n++] = (unsigned char)c;
+}
+
+static void mpc_table_put_int(mpc_table_out_t *t, unsigned long x) {
+  while (x >= 0x80) { mpc_table_put(t, (int)(x & 0x7f) | 0x80); x >>= 7; }
+  mpc_table_put(t, (int)x);
+}
+
+static void mpc_table_put_str(mpc_table_out_t *t, const char *s) {
+  if (s == NULL) { mpc_table_put_int(t, 0); return; }
+  mpc_table_put_int(t, strlen(s) + 1);
+  while (*s) { mpc_table_put(t, *s++); }
+}
+
+static void mpc_table_put_fn(mpc_table_out_t *t, mpc_table_fn_t f) {
+  int j;
+  for (j = 0; j < MPC_TABLE_FNS; j++) {
+    if (mpc_table_fns[j].f == f) { mpc_table_put_int(t, j); return; }
+  }
+  t->bad = "Grammar table cannot hold a user defined function!";
+}
+
+static void mpc_table_put_ref(mpc_table_out_t *t, mpc_parser_t *p) {
+  int j;
+  for (j = 0; j < t->nodes_num; j++) {
+    if (t->nodes[j] == p) { mpc_table_put_int(t, j); return; }
+  }
+}
+
+static void mpc_table_put_data(mpc_table_out_t *t, void *d) {
+
+  int j;
+
+  if (d == NULL) { mpc_table_put_int(t, MPC_TABLE_DATA_NONE); return; }
+
+  for (j = 0; j < t->nodes_num; j++) {
+    if (t->nodes[j]->retained && t->nodes[j]->name == d) {
+      mpc_table_put_int(t, MPC_TABLE_DATA_NAME);
+      mpc_table_put_int(t, j);
+      return;
+    }
+  }
+
+  for (j = 0; j < MPC_TABLE_TAGS; j++) {
+    if (strcmp(mpc_table_tags[j], d) == 0) {
+      mpc_table_put_int(t, MPC_TABLE_DATA_TAG);
+      mpc_table_put_int(t, j);
+      return;
+    }
+  }
+
+  t->bad = "Grammar table cannot hold user data!";
+}
+
+static void mpc_table_collect(mpc_table_out_t *t, mpc_parser_t *p) {
+
+  int j, m;
+  mpc_parser_t **xs;
+
+  for (j = 0; j < t->nodes_num; j++) {
+    if (t->nodes[j] == p) { return; }
+  }
+
+  if (t->nodes_num == t->nodes_slots) {
+    t->nodes_slots = t->nodes_slots ? t->nodes_slots * 2 : 64;
+    t->nodes = realloc(t->nodes, sizeof(mpc_parser_t*) * t->nodes_slots);
+  }
+  t->nodes[t->nodes_num++] = p;
+
+  m = mpc_first_children(p, &xs);
+  for (j = 0; j < m; j++) { mpc_table_collect(t, xs[j]); }
+}
+
+static void mpc_table_put_node(mpc_table_out_t *t, mpc_parser_t *p) {
+
+  int j;
+
+  mpc_table_put(t, p->type);
+  mpc_table_put(t, p->retained);
+  if (p->retained) { mpc_table_put_str(t, p->name); }
+
+  switch (p->type) {
+
+    case MPC_TYPE_FAIL: mpc_table_put_str(t, p->data.fail.m); break;
+
+    case MPC_TYPE_LIFT: mpc_table_put_fn(t, (mpc_table_fn_t)p->data.lift.lf); break;
+    case MPC_TYPE_LIFT_VAL: t->bad = "Grammar table cannot hold user data!"; break;
+
+    case MPC_TYPE_EXPECT:
+      mpc_table_put_ref(t, p->data.expect.x);
+      mpc_table_put_str(t, p->data.expect.m);
+      break;
+
+    case MPC_TYPE_ANCHOR:  mpc_table_put_fn(t, (mpc_table_fn_t)p->data.anchor.f); break;
+    case MPC_TYPE_SATISFY: mpc_table_put_fn(t, (mpc_table_fn_t)p->data.satisfy.f); break;
+
+    case MPC_TYPE_SINGLE: mpc_table_put(t, p->data.single.x); break;
+    case MPC_TYPE_RANGE:
+      mpc_table_put(t, p->data.range.x);
+      mpc_table_put(t, p->data.range.y);
+      break;
+
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+    case MPC_TYPE_STRING: mpc_table_put_str(t, p->data.string.x); break;
+
+    case MPC_TYPE_APPLY:
+      mpc_table_put_ref(t, p->data.apply.x);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.apply.f);
+      break;
+
+    case MPC_TYPE_APPLY_TO:
+      mpc_table_put_ref(t, p->data.apply_to.x);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.apply_to.f);
+      mpc_table_put_data(t, p->data.apply_to.d);
+      break;
+
+    case MPC_TYPE_CHECK:
+      mpc_table_put_ref(t, p->data.check.x);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.check.dx);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.check.f);
+      mpc_table_put_str(t, p->data.check.e);
+      break;
+
+    case MPC_TYPE_CHECK_WITH:
+      mpc_table_put_ref(t, p->data.check_with.x);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.check_with.dx);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.check_with.f);
+      mpc_table_put_data(t, p->data.check_with.d);
+      mpc_table_put_str(t, p->data.check_with.e);
+      break;
+
+    case MPC_TYPE_PREDICT: mpc_table_put_ref(t, p->data.predict.x); break;
+
+    case MPC_TYPE_NOT:
+    case MPC_TYPE_MAYBE:
+      mpc_table_put_ref(t, p->data.not.x);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.not.dx);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.not.lf);
+      break;
+
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+    case MPC_TYPE_COUNT:
+      mpc_table_put_int(t, p->data.repeat.n);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.repeat.f);
+      mpc_table_put_ref(t, p->data.repeat.x);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.repeat.dx);
+      break;
+
+    case MPC_TYPE_SCAN:
+      mpc_table_put_int(t, p->data.scan.n);
+      mpc_table_put_ref(t, p->data.scan.x);
+      for (j = 0; j < MPC_SET_SIZE; j++) { mpc_table_put(t, p->data.scan.s->run[j]); }
+      break;
+
+    case MPC_TYPE_OR:
+      mpc_table_put_int(t, p->data.or.n);
+      for (j = 0; j < p->data.or.n; j++) { mpc_table_put_ref(t, p->data.or.xs[j]); }
+      mpc_table_put(t, p->data.or.jump != NULL);
+      if (p->data.or.jump) {
+        for (j = 0; j < MPC_JUMP_SIZE; j++) { mpc_table_put(t, p->data.or.jump[j]); }
+      }
+      break;
+
+    case MPC_TYPE_AND:
+      mpc_table_put_int(t, p->data.and.n);
+      mpc_table_put_fn(t, (mpc_table_fn_t)p->data.and.f);
+      for (j = 0; j < p->data.and.n; j++) { mpc_table_put_ref(t, p->data.and.xs[j]); }
+      for (j = 0; j < p->data.and.n-1; j++) { mpc_table_put_fn(t, (mpc_table_fn_t)p->data.and.dxs[j]); }
+      break;
+
+    default: break;
+  }
+}
+
+static mpc_err_t *mpca_table_st(FILE *f, const char *name, int n, va_list va) {
+
+  int j;
+  mpc_table_out_t t;
+  mpc_err_t *err = NULL;
+
+  memset(&t, 0, sizeof(mpc_table_out_t));
+
+  for (j = 0; j < n; j++) { mpc_table_collect(&t, va_arg(va, mpc_parser_t*)); }
+
+  for (j = 0; j < 4; j++) { mpc_table_put(&t, mpc_table_magic[j]); }
+  mpc_table_put_int(&t, t.nodes_num);
+  for (j = 0; j < t.nodes_num; j++) { mpc_table_put_node(&t, t.nodes[j]); }
+
+  if (t.bad) {
+    err = mpc_err_file("<mpca_table>", t.bad);
+  } else if (name == NULL) {
+    fwrite(t.s, 1, t.n, f);
+  } else {
+    fprintf(f, "static const unsigned char %s[] = {", name);
+    for (j = 0; j < (int)t.n; j++) {
+      fprintf(f, "%s0x%02x", j % 12 ? ", " : (j ? ",\n  " : "\n  "), t.s[j]);
+    }
+    fprintf(f, "\n};\n");
+  }
+
+  free(t.s);
+  free(t.nodes);
+  return err;
+}
+
+mpc_err_t *mpca_table_write(FILE *f, int n, ...) {
+  mpc_err_t *err;
+  va_list va;
+  va_start(va, n);
+  err = mpca_table_st(f, NULL, n, va);
+  va_end(va);
+  return err;
+}
+
+mpc_err_t *mpca_table_source(FILE *f, const char *name, int n, ...) {
+  mpc_err_t *err;
+  va_list va;
+  va_start(va, n);
+  err = mpca_table_st(f, name, n, va);
+  va_end(va);
+  return err;
+}
+
+/*
+** Tables are read twice. The first pass only
+** checks them, so the second, which builds the
+** parsers, cannot fail half way through.
+*/
+
+typedef struct {
+  const unsigned char *s;
+  size_t n, i;
+  int nodes_num;
+  mpc_parser_t **nodes;
+  int *refs;
+  const char *bad;
+} mpc_table_in_t;
+
+static int mpc_table_get(mpc_table_in_t *t) {
+  if (t->i == t->n) { t->bad = "Grammar table is truncated!"; return 0; }
+  return t->s[t->i++];
+}
+
+static unsigned long mpc_table_get_int(mpc_table_in_t *t) {
+  int c, k = 0;
+  unsigned long x = 0;
+  do {
+    c = mpc_table_get(t);
+    if (k < (int)sizeof(unsigned long) * 8) { x |= (unsigned long)(c & 0x7f) << k; }
+    k += 7;
+  } while ((c & 0x80) && !t->bad);
+  return x;
+}
+
+static char *mpc_table_get_str(mpc_table_in_t *t, int build) {
+  char *s;
+  unsigned long l = mpc_table_get_int(t);
+  if (l == 0 || t->bad) { return NULL; }
+  if (l - 1 > t->n - t->i) { t->bad = "Grammar table is truncated!"; return NULL; }
+  s = NULL;
+  if (build) {
+    s = malloc(l);
+    memcpy(s, t->s + t->i, l - 1);
+    s[l-1] = '\0';
+  }
+  t->i += l - 1;
+  return s;
+}
+
+static mpc_table_fn_t mpc_table_get_fn(mpc_table_in_t *t) {
+  unsigned long j = mpc_table_get_int(t);
+  if (j >= MPC_TABLE_FNS) { t->bad = "Grammar table has an unknown function!"; return NULL; }
+  return mpc_table_fns[j].f;
+}
+
+static mpc_parser_t *mpc_table_get_ref(mpc_table_in_t *t) {
+  unsigned long j = mpc_table_get_int(t);
+  if (j >= (unsigned long)t->nodes_num) { t->bad = "Grammar table has an invalid reference!"; return NULL; }
+  t->refs[j]++;
+  return t->nodes ? t->nodes[j] : NULL;
+}
+
+static void *mpc_table_get_data(mpc_table_in_t *t) {
+  unsigned long k = mpc_table_get_int(t), j;
+  if (k == MPC_TABLE_DATA_NONE) { return NULL; }
+  j = mpc_table_get_int(t);
+  if (k == MPC_TABLE_DATA_NAME && j < (unsigned long)t->nodes_num) {
+    return t->nodes ? t->nodes[j]->name : NULL;
+  }
+  if (k == MPC_TABLE_DATA_TAG && j < MPC_TABLE_TAGS) {
+    return (void*)mpc_table_tags[j];
+  }
+  t->bad = "Grammar table has invalid data!";
+  return NULL;
+}
+
+/*
+** Reads the data of the next node into `p`, or
+** just checks it when `p` is NULL.
+*/
+
+static void mpc_table_get_node(mpc_table_in_t *t, int type, mpc_parser_t *p) {
+
+  int j, n, build = p != NULL;
+  mpc_parser_t *x;
+  mpc_table_fn_t f, g;
+  unsigned char run[MPC_SET_SIZE];
+  char *s;
+  void *d;
+
+  switch (type) {
+
+    case MPC_TYPE_UNDEFINED:
+    case MPC_TYPE_PASS:
+    case MPC_TYPE_STATE:
+    case MPC_TYPE_ANY:
+    case MPC_TYPE_SOI:
+    case MPC_TYPE_EOI:
+      break;
+
+    case MPC_TYPE_FAIL:
+      s = mpc_table_get_str(t, build);
+      if (build) { p->data.fail.m = s; }
+      break;
+
+    case MPC_TYPE_LIFT:
+      f = mpc_table_get_fn(t);
+      if (build) { p->data.lift.lf = (mpc_ctor_t)f; }
+      break;
+
+    case MPC_TYPE_EXPECT:
+      x = mpc_table_get_ref(t);
+      s = mpc_table_get_str(t, build);
+      if (build) { p->data.expect.x = x; p->data.expect.m = s; }
+      break;
+
+    case MPC_TYPE_ANCHOR:
+      f = mpc_table_get_fn(t);
+      if (build) { p->data.anchor.f = (int(*)(char,char))f; }
+      break;
+
+    case MPC_TYPE_SATISFY:
+      f = mpc_table_get_fn(t);
+      if (build) { p->data.satisfy.f = (int(*)(char))f; }
+      break;
+
+    case MPC_TYPE_SINGLE:
+      j = mpc_table_get(t);
+      if (build) { p->data.single.x = (char)j; }
+      break;
+
+    case MPC_TYPE_RANGE:
+      j = mpc_table_get(t);
+      n = mpc_table_get(t);
+      if (build) { p->data.range.x = (char)j; p->data.range.y = (char)n; }
+      break;
+
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+    case MPC_TYPE_STRING:
+      s = mpc_table_get_str(t, build);
+      if (!build) { break; }
+      p->data.string.x = s ? s : calloc(1, 1);
+      if (type != MPC_TYPE_STRING) {
+        mpc_set_build(p->data.string.set, p->data.string.x, type == MPC_TYPE_NONEOF);
+      }
+      break;
+
+    case MPC_TYPE_APPLY:
+      x = mpc_table_get_ref(t);
+      f = mpc_table_get_fn(t);
+      if (build) { p->data.apply.x = x; p->data.apply.f = (mpc_apply_t)f; }
+      break;
+
+    case MPC_TYPE_APPLY_TO:
+      x = mpc_table_get_ref(t);
+      f = mpc_table_get_fn(t);
+      d = mpc_table_get_data(t);
+      if (build) { p->data.apply_to.x = x; p->data.apply_to.f = (mpc_apply_to_t)f; p->data.apply_to.d = d; }
+      break;
+
+    case MPC_TYPE_CHECK:
+      x = mpc_table_get_ref(t);
+      f = mpc_table_get_fn(t);
+      g = mpc_table_get_fn(t);
+      s = mpc_table_get_str(t, build);
+      if (!build) { break; }
+      p->data.check.x = x;
+      p->data.check.dx = (mpc_dtor_t)f;
+      p->data.check.f = (mpc_check_t)g;
+      p->data.check.e = s ? s : calloc(1, 1);
+      break;
+
+    case MPC_TYPE_CHECK_WITH:
+      x = mpc_table_get_ref(t);
+      f = mpc_table_get_fn(t);
+      g = mpc_table_get_fn(t);
+      d = mpc_table_get_data(t);
+      s = mpc_table_get_str(t, build);
+      if (!build) { break; }
+      p->data.check_with.x = x;
+      p->data.check_with.dx = (mpc_dtor_t)f;
+      p->data.check_with.f = (mpc_check_with_t)g;
+      p->data.check_with.d = d;
+      p->data.check_with.e = s ? s : calloc(1, 1);
+      break;
+
+    case MPC_TYPE_PREDICT:
+      x = mpc_table_get_ref(t);
+      if (build) { p->data.predict.x = x; }
+      break;
+
+    case MPC_TYPE_NOT:
+    case MPC_TYPE_MAYBE:
+      x = mpc_table_get_ref(t);
+      f = mpc_table_get_fn(t);
+      g = mpc_table_get_fn(t);
+      if (build) { p->data.not.x = x; p->data.not.dx = (mpc_dtor_t)f; p->data.not.lf = (mpc_ctor_t)g; }
+      break;
+
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+    case MPC_TYPE_COUNT:
+      n = (int)mpc_table_get_int(t);
+      f = mpc_table_get_fn(t);
+      x = mpc_table_get_ref(t);
+      g = mpc_table_get_fn(t);
+      if (!build) { break; }
+      p->data.repeat.n = n;
+      p->data.repeat.f = (mpc_fold_t)f;
+      p->data.repeat.x = x;
+      p->data.repeat.dx = (mpc_dtor_t)g;
+      break;
+
+    case MPC_TYPE_SCAN:
+      n = (int)mpc_table_get_int(t);
+      x = mpc_table_get_ref(t);
+      for (j = 0; j < MPC_SET_SIZE; j++) { run[j] = mpc_table_get(t); }
+      if (!build) { break; }
+      p->data.scan.n = n;
+      p->data.scan.x = x;
+      p->data.scan.s = malloc(sizeof(mpc_scan_t));
+      mpc_scan_build(p->data.scan.s, run);
+      break;
+
+    case MPC_TYPE_OR:
+      n = (int)mpc_table_get_int(t);
+      if (n < 0 || (size_t)n > t->n - t->i) { t->bad = "Grammar table is truncated!"; break; }
+      if (build) {
+        p->data.or.n = n;
+        p->data.or.xs = malloc(sizeof(mpc_parser_t*) * n);
+        p->data.or.jump = NULL;
+      }
+      for (j = 0; j < n; j++) {
+        x = mpc_table_get_ref(t);
+        if (build) { p->data.or.xs[j] = x; }
+      }
+      if (mpc_table_get(t)) {
+        if (build) { p->data.or.jump = malloc(MPC_JUMP_SIZE); }
+        for (j = 0; j < MPC_JUMP_SIZE; j++) {
+          n = mpc_table_get(t);
+          if (build) { p->data.or.jump[j] = n; }
+        }
+      }
+      break;
+
+    case MPC_TYPE_AND:
+      n = (int)mpc_table_get_int(t);
+      f = mpc_table_get_fn(t);
+      if (n < 1 || (size_t)n > t->n - t->i) { t->bad = "Grammar table is truncated!"; break; }
+      if (build) {
+        p->data.and.n = n;
+        p->data.and.f = (mpc_fold_t)f;
+        p->data.and.xs = malloc(sizeof(mpc_parser_t*) * n);
+        p->data.and.dxs = malloc(sizeof(mpc_dtor_t) * (n - 1));
+      }
+      for (j = 0; j < n; j++) {
+        x = mpc_table_get_ref(t);
+        if (build) { p->data.and.xs[j] = x; }
+      }
+      for (j = 0; j < n - 1; j++) {
+        f = mpc_table_get_fn(t);
+        if (build) { p->data.and.dxs[j] = (mpc_dtor_t)f; }
+      }
+      break;
+
+    default:
+      t->bad = "Grammar table has an unknown parser type!";
+      break;
+  }
+}
+
+static mpc_err_t *mpca_table_st_read(mpc_table_in_t *t, mpc_parser_t **ps, int n) {
+
+  int j, k, type, retained;
+  size_t start;
+  char *name;
+  mpc_parser_t **targets, *p;
+
+  if (t->n < 4 || memcmp(t->s, mpc_table_magic, 4) != 0) {
+    return mpc_err_file("<mpca_table>", "Grammar table has the wrong format!");
+  }
+
+  t->i = 4;
+  t->nodes_num = (int)mpc_table_get_int(t);
+  if (t->bad || t->nodes_num < 0 || (size_t)t->nodes_num > t->n) {
+    return mpc_err_file("<mpca_table>", "Grammar table is truncated!");
+  }
+  start = t->i;
+
+  t->refs = calloc(t->nodes_num, sizeof(int));
+  targets = calloc(t->nodes_num, sizeof(mpc_parser_t*));
+
+  /* Check */
+
+  for (j = 0; j < t->nodes_num && !t->bad; j++) {
+    type = mpc_table_get(t);
+    retained = mpc_table_get(t);
+    if (retained) {
+      name = mpc_table_get_str(t, 1);
+      for (k = 0; k < n && !targets[j]; k++) {
+        if (name && strcmp(ps[k]->name, name) == 0) { targets[j] = ps[k]; }
+      }
+      if (!targets[j]) { t->bad = "Grammar table needs a parser which was not given!"; }
+      else if (targets[j]->frozen) { t->bad = "Grammar table can not define a frozen parser!"; }
+      free(name);
+    }
+    mpc_table_get_node(t, type, NULL);
+  }
+
+  for (j = 0; j < t->nodes_num && !t->bad; j++) {
+    if (!targets[j] && t->refs[j] != 1) { t->bad = "Grammar table has an invalid reference!"; }
+  }
+
+  if (t->bad) {
+    free(t->refs);
+    free(targets);
+    return mpc_err_file("<mpca_table>", t->bad);
+  }
+
+  /* Build */
+
+  t->nodes = malloc(sizeof(mpc_parser_t*) * t->nodes_num);
+  for (j = 0; j < t->nodes_num; j++) {
+    t->nodes[j] = targets[j] ? targets[j] : mpc_undefined();
+  }
+
+  t->i = start;
+  for (j = 0; j < t->nodes_num; j++) {
+    type = mpc_table_get(t);
+    retained = mpc_table_get(t);
+    if (retained) { mpc_table_get_str(t, 0); }
+    p = targets[j] ? mpc_undefined() : t->nodes[j];
+    p->type = type;
+    mpc_table_get_node(t, type, p);
+    if (targets[j]) { mpc_define(mpc_undefine(targets[j]), p); }
+  }
+
+  free(t->refs);
+  free(t->nodes);
+  free(targets);
+  return NULL;
+}
+
+mpc_err_t *mpca_table(const void *table, size_t length, int n, ...) {
+
+  int j;
+  mpc_table_in_t t;
+  mpc_parser_t **ps = malloc(sizeof(mpc_parser_t*) * n);
+  mpc_err_t *err;
+
+  va_list va;
+  va_start(va, n);
+  for (j = 0; j < n; j++) { ps[j] = va_arg(va, mpc_parser_t*); }
+  va_end(va);
+
+  memset(&t, 0, sizeof(mpc_table_in_t));
+  t.s = table;
+  t.n = length;
+  err = mpca_table_st_read(&t, ps, n);
+
+  free(ps);
+  return err;
+}
+
+
+
+/*
+** Code Generation
+*/
+
+/*
+** Writes C source for a parser specialised to a
+** grammar. Each rule becomes a function with the
+** parsers it is built from written out inline, so
+** characters are tested directly and results are
+** folded by calling the fold functions themselves.
+** The generated parser decides success exactly as
+** `mpc_parse` would and builds the same output,
+** but it builds no errors. On failure it runs the
+** grammar again with `mpc_parse` for the error.
+**
+** Instead of an error a failure only keeps the
+** position the error would have had, or -1 for no
+** error, as that is all predicted alternatives use.
+**
+** With `arena` set the entry point builds the AST
+** in an arena as `mpc_parse_arena` does.
+*/
+
+typedef struct {
+  char *s;
+  size_t n, m;
+} mpc_gen_buf_t;
+
+typedef struct {
+  const char *name;
+  mpc_table_out_t t;
+  mpc_gen_buf_t data, code;
+  int vars, tables, indent;
+} mpc_gen_t;
+
+static void mpc_gen_vprintf(mpc_gen_buf_t *b, const char *fmt, va_list va) {
+  int l;
+  va_list vb;
+  va_copy(vb, va);
+  l = vsnprintf(NULL, 0, fmt, vb);
+  va_end(vb);
+  if (b->n + l + 1 > b->m) {
+    b->m = (b->n + l + 1) * 2;
+    b->s = realloc(b->s, b->m);
+  }
+  vsnprintf(b->s + b->n, l + 1, fmt, va);
+  b->n += l;
+}
+
+static void mpc_gen_printf(mpc_gen_buf_t *b, const char *fmt, ...) {
+  va_list va;
+  va_start(va, fmt);
+  mpc_gen_vprintf(b, fmt, va);
+  va_end(va);
+}
+
+static void mpc_gen_line(mpc_gen_t *g, const char *fmt, ...) {
+  va_list va;
+  mpc_gen_printf(&g->code, "%*s", g->indent * 2, "");
+  va_start(va, fmt);
+  mpc_gen_vprintf(&g->code, fmt, va);
+  va_end(va);
+  mpc_gen_printf(&g->code, "\n");
+}
+
+static const char *mpc_gen_fn(mpc_gen_t *g, mpc_table_fn_t f) {
+  int j;
+  for (j = 1; j < MPC_TABLE_FNS; j++) {
+    if (mpc_table_fns[j].f == f && mpc_table_fns[j].name) { return mpc_table_fns[j].name; }
+  }
+  g->t.bad = "Generated parsers can only use the functions of mpc!";
+  return "NULL";
+}
+
+/* Returns `s` as a C string literal, to be freed */
+static char *mpc_gen_quote(const char *s) {
+  mpc_gen_buf_t b;
+  memset(&b, 0, sizeof(mpc_gen_buf_t));
+  mpc_gen_printf(&b, "\"");
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\') { mpc_gen_printf(&b, "\\%c", *s); }
+    else if (*s >= ' ' && *s <= '~' && *s != '?') { mpc_gen_printf(&b, "%c", *s); }
+    else { mpc_gen_printf(&b, "\\%03o", (unsigned char)*s); }
+  }
+  mpc_gen_printf(&b, "\"");
+  return b.s;
+}
+
+/* Returns the data of `apply_to` or `check_with` as C, to be freed */
+static char *mpc_gen_quote_data(mpc_gen_t *g, void *d) {
+
+  int j;
+  char *s;
+
+  if (d == NULL) {
+    s = malloc(5);
+    strcpy(s, "NULL");
+    return s;
+  }
+
+  for (j = 0; j < g->t.nodes_num; j++) {
+    if (g->t.nodes[j]->retained && g->t.nodes[j]->name == d) { return mpc_gen_quote(d); }
+  }
+
+  for (j = 0; j < MPC_TABLE_TAGS; j++) {
+    if (strcmp(mpc_table_tags[j], d) == 0) { return mpc_gen_quote(d); }
+  }
+
+  g->t.bad = "Generated parsers cannot use user data!";
+  return mpc_gen_quote("");
+}
+
+static void mpc_gen_char(char *o, char c) {
+  if (c >= ' ' && c <= '~' && c != '\'' && c != '\\') { sprintf(o, "'%c'", c); }
+  else { sprintf(o, "'\\%03o'", (unsigned char)c); }
+}
+
+static int mpc_gen_set(mpc_gen_t *g, const unsigned char *set) {
+  int j, id = g->tables++;
+  mpc_gen_printf(&g->data, "static const unsigned char %s_set%d[32] = {", g->name, id);
+  for (j = 0; j < MPC_SET_SIZE; j++) {
+    mpc_gen_printf(&g->data, "%s%d", j ? ", " : " ", set[j]);
+  }
+  mpc_gen_printf(&g->data, " };\n");
+  return id;
+}
+
+static int mpc_gen_rule(mpc_gen_t *g, mpc_parser_t *p) {
+  int j;
+  for (j = 0; j < g->t.nodes_num; j++) {
+    if (g->t.nodes[j] == p) { return j; }
+  }
+  return 0;
+}
+
+#define MPC_GEN_ERROR "c->sup ? -1 : c->pos"
+
+/*
+** Writes the code for `p` at `k` parsers below the
+** rule it is in, returning the number of variables
+** `okN`, `vN` and `eN` holding the outcome.
+*/
+
+static int mpc_gen_node(mpc_gen_t *g, mpc_parser_t *p, int k, int top) {
+
+  int i, j, x, id = g->vars++;
+  const char *f;
+  char *d, a[8], b[8];
+
+  mpc_gen_line(g, "int ok%d = 0; mpc_val_t *v%d = NULL; long e%d = -1;", id, id, id);
+
+  if (p->retained && !top) {
+    mpc_gen_line(g, "ok%d = %s_%d(c, &v%d, &e%d, depth + %d);",
+      id, g->name, mpc_gen_rule(g, p), id, id, k);
+    return id;
+  }
+
+  mpc_gen_line(g, "if (depth + %d == c->max) { e%d = " MPC_GEN_ERROR "; } else {", k, id);
+  g->indent++;
+
+  switch (p->type) {
+
+    /* Basic Parsers */
+
+    case MPC_TYPE_ANY:
+      mpc_gen_line(g, "if (c->s[c->pos]) { ok%d = 1; v%d = %s_chr(c); }", id, id, g->name);
+      break;
+
+    case MPC_TYPE_SINGLE:
+      if (p->data.single.x == '\0') { break; }
+      mpc_gen_char(a, p->data.single.x);
+      mpc_gen_line(g, "if (c->s[c->pos] == %s) { ok%d = 1; v%d = %s_chr(c); }", a, id, id, g->name);
+      break;
+
+    case MPC_TYPE_RANGE:
+      mpc_gen_char(a, p->data.range.x);
+      mpc_gen_char(b, p->data.range.y);
+      mpc_gen_line(g, "if (c->s[c->pos] && c->s[c->pos] >= %s && c->s[c->pos] <= %s) { ok%d = 1; v%d = %s_chr(c); }",
+        a, b, id, id, g->name);
+      break;
+
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+      x = mpc_gen_set(g, p->data.string.set);
+      mpc_gen_line(g, "if (%s_in(%s_set%d, c->s[c->pos])) { ok%d = 1; v%d = %s_chr(c); }",
+        g->name, g->name, x, id, id, g->name);
+      break;
+
+    case MPC_TYPE_SATISFY:
+      mpc_gen_line(g, "if (c->s[c->pos] && %s(c->s[c->pos])) { ok%d = 1; v%d = %s_chr(c); }",
+        mpc_gen_fn(g, (mpc_table_fn_t)p->data.satisfy.f), id, id, g->name);
+      break;
+
+    case MPC_TYPE_STRING:
+      d = mpc_gen_quote(p->data.string.x);
+      mpc_gen_line(g, "ok%d = %s_str(c, %s, &v%d);", id, g->name, d, id);
+      free(d);
+      break;
+
+    case MPC_TYPE_ANCHOR:
+      mpc_gen_line(g, "ok%d = %s(c->pos ? c->s[c->pos-1] : '\\0', c->s[c->pos]);",
+        id, mpc_gen_fn(g, (mpc_table_fn_t)p->data.anchor.f));
+      break;
+
+    case MPC_TYPE_SOI: mpc_gen_line(g, "ok%d = c->pos == 0;", id); break;
+    case MPC_TYPE_EOI:
+      mpc_gen_line(g, "if (!c->term && !c->s[c->pos]) { c->term = 1; ok%d = 1; }", id);
+      break;
+
+    /* Other parsers */
+
+    case MPC_TYPE_UNDEFINED:
+    case MPC_TYPE_FAIL:     mpc_gen_line(g, "e%d = " MPC_GEN_ERROR ";", id); break;
+    case MPC_TYPE_PASS:     mpc_gen_line(g, "ok%d = 1;", id); break;
+    case MPC_TYPE_LIFT:
+      mpc_gen_line(g, "ok%d = 1; v%d = %s();", id, id, mpc_gen_fn(g, (mpc_table_fn_t)p->data.lift.lf));
+      break;
+    case MPC_TYPE_LIFT_VAL: g->t.bad = "Generated parsers cannot use user data!"; break;
+    case MPC_TYPE_STATE:    mpc_gen_line(g, "ok%d = 1; v%d = %s_state(c);", id, id, g->name); break;
+
+    /* Application Parsers */
+
+    case MPC_TYPE_APPLY:
+      x = mpc_gen_node(g, p->data.apply.x, k+1, 0);
+      if (p->data.apply.f == mpcf_str_ast) {
+        mpc_gen_line(g, "if (ok%d) { ok%d = 1; v%d = %s_str_ast(c, v%d); } else { e%d = e%d; }",
+          x, id, id, g->name, x, id, x);
+        break;
+      }
+      mpc_gen_line(g, "if (ok%d) { ok%d = 1; v%d = %s(v%d); } else { e%d = e%d; }",
+        x, id, id, mpc_gen_fn(g, (mpc_table_fn_t)p->data.apply.f), x, id, x);
+      break;
+
+    case MPC_TYPE_APPLY_TO:
+      x = mpc_gen_node(g, p->data.apply_to.x, k+1, 0);
+      d = mpc_gen_quote_data(g, p->data.apply_to.d);
+      mpc_gen_line(g, "if (ok%d) { ok%d = 1; v%d = %s(v%d, %s); } else { e%d = e%d; }",
+        x, id, id, mpc_gen_fn(g, (mpc_table_fn_t)p->data.apply_to.f), x, d, id, x);
+      free(d);
+      break;
+
+    case MPC_TYPE_CHECK:
+      x = mpc_gen_node(g, p->data.check.x, k+1, 0);
+      mpc_gen_line(g, "if (!ok%d) { e%d = e%d; }", x, id, x);
+      mpc_gen_line(g, "else if (%s(&v%d)) { ok%d = 1; v%d = v%d; }",
+        mpc_gen_fn(g, (mpc_table_fn_t)p->data.check.f), x, id, id, x);
+      mpc_gen_line(g, "else { %s(v%d); e%d = " MPC_GEN_ERROR "; }",
+        mpc_gen_fn(g, (mpc_table_fn_t)p->data.check.dx), x, id);
+      break;
+
+    case MPC_TYPE_CHECK_WITH:
+      x = mpc_gen_node(g, p->data.check_with.x, k+1, 0);
+      d = mpc_gen_quote_data(g, p->data.check_with.d);
+      mpc_gen_line(g, "if (!ok%d) { e%d = e%d; }", x, id, x);
+      mpc_gen_line(g, "else if (%s(&v%d, %s)) { ok%d = 1; v%d = v%d; }",
+        mpc_gen_fn(g, (mpc_table_fn_t)p->data.check_with.f), x, d, id, id, x);
+      mpc_gen_line(g, "else { %s(v%d); e%d = " MPC_GEN_ERROR "; }",
+        mpc_gen_fn(g, (mpc_table_fn_t)p->data.check_with.dx), x, id);
+      free(d);
+      break;
+
+    case MPC_TYPE_EXPECT:
+      mpc_gen_line(g, "c->sup++;");
+      x = mpc_gen_node(g, p->data.expect.x, k+1, 0);
+      mpc_gen_line(g, "c->sup--; (void)e%d;", x);
+      mpc_gen_line(g, "if (ok%d) { ok%d = 1; v%d = v%d; } else { e%d = " MPC_GEN_ERROR "; }",
+        x, id, id, x, id);
+      break;
+
+    case MPC_TYPE_PREDICT:
+      mpc_gen_line(g, "c->bt--;");
+      x = mpc_gen_node(g, p->data.predict.x, k+1, 0);
+      mpc_gen_line(g, "c->bt++;");
+      mpc_gen_line(g, "ok%d = ok%d; v%d = v%d; e%d = e%d;", id, x, id, x, id, x);
+      break;
+
+    /* Optional Parsers */
+
+    case MPC_TYPE_NOT:
+      mpc_gen_line(g, "long p%d = c->pos; int t%d = c->term;", id, id);
+      mpc_gen_line(g, "c->sup++;");
+      x = mpc_gen_node(g, p->data.not.x, k+1, 0);
+      mpc_gen_line(g, "(void)e%d;", x);
+      mpc_gen_line(g, "if (ok%d) {", x);
+      mpc_gen_line(g, "  if (c->bt > 0) { c->pos = p%d; c->term = t%d; }", id, id);
+      mpc_gen_line(g, "  c->sup--; %s(v%d); e%d = " MPC_GEN_ERROR ";",
+        mpc_gen_fn(g, (mpc_table_fn_t)p->data.not.dx), x, id);
+      mpc_gen_line(g, "} else { c->sup--; ok%d = 1; v%d = %s(); }",
+        id, id, mpc_gen_fn(g, (mpc_table_fn_t)p->data.not.lf));
+      break;
+
+    case MPC_TYPE_MAYBE:
+      x = mpc_gen_node(g, p->data.not.x, k+1, 0);
+      mpc_gen_line(g, "(void)e%d;", x);
+      mpc_gen_line(g, "ok%d = 1; v%d = ok%d ? v%d : %s();",
+        id, id, x, x, mpc_gen_fn(g, (mpc_table_fn_t)p->data.not.lf));
+      break;
+
+    /* Repeat Parsers */
+
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+
+      /* Strings are joined as they are read */
+      if (p->data.repeat.f == mpcf_strfold) {
+        mpc_gen_line(g, "char *b%d = NULL; size_t l%d = 0, m%d = 0; int j%d = 0;", id, id, id, id);
+        mpc_gen_line(g, "for (;;) {");
+        g->indent++;
+        x = mpc_gen_node(g, p->data.repeat.x, k+1, 0);
+        mpc_gen_line(g, "if (!ok%d) { e%d = e%d; break; }", x, id, x);
+        mpc_gen_line(g, "%s_cat(&b%d, &l%d, &m%d, v%d, strlen(v%d)); free(v%d); j%d++;",
+          g->name, id, id, id, x, x, x, id);
+        g->indent--;
+        mpc_gen_line(g, "}");
+        if (p->type == MPC_TYPE_MANY) {
+          mpc_gen_line(g, "ok%d = 1; v%d = b%d ? b%d : calloc(1, 1);", id, id, id, id);
+        } else {
+          mpc_gen_line(g, "if (j%d) { ok%d = 1; v%d = b%d; }", id, id, id, id);
+        }
+        break;
+      }
+
+      mpc_gen_line(g, "mpc_val_t *s%d[8], **xs%d = s%d; int j%d = 0, m%d = 8;", id, id, id, id, id);
+      mpc_gen_line(g, "for (;;) {");
+      g->indent++;
+      x = mpc_gen_node(g, p->data.repeat.x, k+1, 0);
+      mpc_gen_line(g, "if (!ok%d) { e%d = e%d; break; }", x, id, x);
+      mpc_gen_line(g, "%s_push(&xs%d, &j%d, &m%d, s%d, v%d);", g->name, id, id, id, id, x);
+      g->indent--;
+      mpc_gen_line(g, "}");
+      f = mpc_gen_fn(g, (mpc_table_fn_t)p->data.repeat.f);
+      if (p->type == MPC_TYPE_MANY) {
+        mpc_gen_line(g, "ok%d = 1; v%d = %s(j%d, xs%d);", id, id, f, id, id);
+      } else {
+        mpc_gen_line(g, "if (j%d) { ok%d = 1; v%d = %s(j%d, xs%d); }", id, id, id, f, id, id);
+      }
+      mpc_gen_line(g, "if (xs%d != s%d) { free(xs%d); }", id, id, id);
+      break;
+
+    case MPC_TYPE_COUNT:
+      if (p->data.repeat.n < 1) { g->t.bad = "Generated parsers cannot count zero times!"; break; }
+      mpc_gen_line(g, "mpc_val_t *xs%d[%d]; int j%d = 0;", id, p->data.repeat.n, id);
+      mpc_gen_line(g, "while (j%d < %d) {", id, p->data.repeat.n);
+      g->indent++;
+      x = mpc_gen_node(g, p->data.repeat.x, k+1, 0);
+      mpc_gen_line(g, "if (!ok%d) { e%d = e%d; break; }", x, id, x);
+      mpc_gen_line(g, "xs%d[j%d++] = v%d;", id, id, x);
+      g->indent--;
+      mpc_gen_line(g, "}");
+      mpc_gen_line(g, "if (j%d == %d) { ok%d = 1; v%d = %s(j%d, xs%d); }",
+        id, p->data.repeat.n, id, id, mpc_gen_fn(g, (mpc_table_fn_t)p->data.repeat.f), id, id);
+      mpc_gen_line(g, "else { while (j%d) { %s(xs%d[--j%d]); } }",
+        id, mpc_gen_fn(g, (mpc_table_fn_t)p->data.repeat.dx), id, id);
+      break;
+
+    case MPC_TYPE_SCAN:
+      j = mpc_gen_set(g, p->data.scan.s->run);
+      mpc_gen_line(g, "char *b%d = NULL; size_t l%d = 0, m%d = 0; long j%d = 0, q%d;", id, id, id, id, id);
+      mpc_gen_line(g, "for (;;) {");
+      g->indent++;
+      mpc_gen_line(g, "for (q%d = c->pos; %s_in(%s_set%d, c->s[c->pos]); c->pos++);", id, g->name, g->name, j);
+      mpc_gen_line(g, "%s_cat(&b%d, &l%d, &m%d, c->s + q%d, c->pos - q%d); j%d += c->pos - q%d;",
+        g->name, id, id, id, id, id, id, id);
+      if (mpc_scan_is_class(p->data.scan.x)) {
+        if (p->data.scan.x->type == MPC_TYPE_EXPECT) {
+          mpc_gen_line(g, "e%d = " MPC_GEN_ERROR ";", id);
+        }
+        mpc_gen_line(g, "break;");
+      } else {
+        x = mpc_gen_node(g, p->data.scan.x, k+1, 0);
+        mpc_gen_line(g, "if (!ok%d) { e%d = e%d; break; }", x, id, x);
+        mpc_gen_line(g, "%s_cat(&b%d, &l%d, &m%d, v%d, strlen(v%d)); free(v%d); j%d++;",
+          g->name, id, id, id, x, x, x, id);
+      }
+      g->indent--;
+      mpc_gen_line(g, "}");
+      mpc_gen_line(g, "if (j%d >= %d) { ok%d = 1; v%d = b%d; e%d = -1; } else { free(b%d); }",
+        id, p->data.scan.n, id, id, id, id, id);
+      break;
+
+    /* Combinatory Parsers */
+
+    case MPC_TYPE_OR:
+
+      if (p->data.or.n == 0) { mpc_gen_line(g, "ok%d = 1;", id); break; }
+
+      /*
+      ** Alternatives are tried by a loop over a
+      ** switch so that a predicted one can be tried
+      ** first without writing its code out twice.
+      */
+
+      mpc_gen_line(g, "int j%d = 0, only%d = 0; long s%d = c->pos;", id, id, id);
+      if (p->data.or.jump) {
+        x = g->tables++;
+        mpc_gen_printf(&g->data, "static const unsigned char %s_jump%d[256] = {", g->name, x);
+        for (j = 0; j < MPC_JUMP_SIZE; j++) {
+          mpc_gen_printf(&g->data, "%s%d", j % 32 ? ", " : (j ? ",\n  " : "\n  "), p->data.or.jump[j]);
+        }
+        mpc_gen_printf(&g->data, "\n};\n");
+        mpc_gen_line(g, "j%d = %s_jump%d[(unsigned char)c->s[c->pos]];", id, g->name, x);
+        mpc_gen_line(g, "if (j%d != %d && j%d != %d) { j%d--; only%d = 1; } else { j%d = 0; }",
+          id, MPC_JUMP_NONE, id, MPC_JUMP_MANY, id, id, id);
+      }
+      mpc_gen_line(g, "(void)s%d;", id);
+      mpc_gen_line(g, "for (; j%d < %d; j%d++) {", id, p->data.or.n, id);
+      g->indent++;
+      mpc_gen_line(g, "int ok = 0; mpc_val_t *v = NULL; long e = -1;");
+      mpc_gen_line(g, "switch (j%d) {", id);
+      for (j = 0; j < p->data.or.n; j++) {
+        mpc_gen_line(g, "case %d: {", j);
+        g->indent++;
+        x = mpc_gen_node(g, p->data.or.xs[j], k+1, 0);
+        mpc_gen_line(g, "ok = ok%d; v = v%d; e = e%d;", x, x, x);
+        mpc_gen_line(g, "break;");
+        g->indent--;
+        mpc_gen_line(g, "}");
+      }
+      mpc_gen_line(g, "}");
+      mpc_gen_line(g, "if (ok) { ok%d = 1; v%d = v; break; }", id, id);
+      mpc_gen_line(g, "if (only%d) { if (e > s%d) { break; } only%d = 0; j%d = -1; }", id, id, id, id);
+      g->indent--;
+      mpc_gen_line(g, "}");
+      break;
+
+    case MPC_TYPE_AND:
+
+      if (p->data.and.n == 0) { mpc_gen_line(g, "ok%d = 1;", id); break; }
+
+      mpc_gen_line(g, "long p%d = c->pos; int t%d = c->term; mpc_val_t *xs%d[%d];",
+        id, id, id, p->data.and.n);
+      mpc_gen_line(g, "do {");
+      g->indent++;
+      for (j = 0; j < p->data.and.n; j++) {
+        x = mpc_gen_node(g, p->data.and.xs[j], k+1, 0);
+        mpc_gen_line(g, "if (!ok%d) {", x);
+        mpc_gen_line(g, "  if (c->bt > 0) { c->pos = p%d; c->term = t%d; }", id, id);
+        for (i = 0; i < j; i++) {
+          mpc_gen_line(g, "  %s(xs%d[%d]);", mpc_gen_fn(g, (mpc_table_fn_t)p->data.and.dxs[i]), id, i);
+        }
+        mpc_gen_line(g, "  e%d = e%d; break;", id, x);
+        mpc_gen_line(g, "}");
+        mpc_gen_line(g, "xs%d[%d] = v%d;", id, j, x);
+      }
+      f = mpc_gen_fn(g, (mpc_table_fn_t)p->data.and.f);
+      mpc_gen_line(g, "ok%d = 1; v%d = %s(%d, xs%d);", id, id, f, p->data.and.n, id);
+      g->indent--;
+      mpc_gen_line(g, "} while (0);");
+      break;
+
+    default:
+      mpc_gen_line(g, "e%d = " MPC_GEN_ERROR ";", id);
+      break;
+  }
+
+  g->indent--;
+  mpc_gen_line(g, "}");
+  return id;
+}
+
+static void mpc_gen_prelude(FILE *f, const char *n, const char *code) {
+
+  char use[64];
+
+  fprintf(f,
+    "typedef struct {\n"
+    "  const char *s;\n"
+    "  long pos;\n"
+    "  int term, bt, sup;\n"
+    "  long rpos, row, col;\n"
+    "  int max;\n"
+    "  mpc_arena_t *arena;\n"
+    "} %s_ctx_t;\n\n", n);
+
+  sprintf(use, "%.40s_in(", n);
+  if (strstr(code, use)) {
+    fprintf(f,
+      "static int %s_in(const unsigned char *set, char x) {\n"
+      "  return (set[(unsigned char)x / 8] >> ((unsigned char)x %% 8)) & 1;\n"
+      "}\n\n", n);
+  }
+
+  sprintf(use, "%.40s_chr(", n);
+  if (strstr(code, use)) {
+    fprintf(f,
+      "static char *%s_chr(%s_ctx_t *c) {\n"
+      "  char *o = malloc(2);\n"
+      "  o[0] = c->s[c->pos++];\n"
+      "  o[1] = '\\0';\n"
+      "  return o;\n"
+      "}\n\n", n, n);
+  }
+
+  sprintf(use, "%.40s_str(", n);
+  if (strstr(code, use)) {
+    fprintf(f,
+      "static int %s_str(%s_ctx_t *c, const char *x, mpc_val_t **o) {\n"
+      "  long j = 0;\n"
+      "  while (x[j] && c->s[c->pos + j] == x[j]) { j++; }\n"
+      "  if (x[j]) {\n"
+      "    if (c->bt < 1) { c->pos += j; }\n"
+      "    return 0;\n"
+      "  }\n"
+      "  c->pos += j;\n"
+      "  *o = malloc(j + 1);\n"
+      "  memcpy(*o, x, j + 1);\n"
+      "  return 1;\n"
+      "}\n\n", n, n);
+  }
+
+  sprintf(use, "%.40s_state(", n);
+  if (strstr(code, use)) {
+    fprintf(f,
+      "static mpc_state_t *%s_state(%s_ctx_t *c) {\n"
+      "  mpc_state_t *s = malloc(sizeof(mpc_state_t));\n"
+      "  if (c->pos < c->rpos) { c->rpos = 0; c->row = 0; c->col = 0; }\n"
+      "  for (; c->rpos < c->pos; c->rpos++) {\n"
+      "    if (c->s[c->rpos] == '\\n') { c->row++; c->col = 0; } else { c->col++; }\n"
+      "  }\n"
+      "  s->pos = c->pos;\n"
+      "  s->row = c->row;\n"
+      "  s->col = c->col;\n"
+      "  s->term = c->term;\n"
+      "  return s;\n"
+      "}\n\n", n, n);
+  }
+
+  sprintf(use, "%.40s_str_ast(", n);
+  if (strstr(code, use)) {
+    fprintf(f,
+      "static mpc_val_t *%s_str_ast(%s_ctx_t *c, mpc_val_t *x) {\n"
+      "  mpc_ast_t *a;\n"
+      "  if (c->arena == NULL) { return mpcf_str_ast(x); }\n"
+      "  a = mpc_arena_ast_new(c->arena, \"\", x);\n"
+      "  free(x);\n"
+      "  return a;\n"
+      "}\n\n", n, n);
+  }
+
+  sprintf(use, "%.40s_cat(", n);
+  if (strstr(code, use)) {
+    fprintf(f,
+      "static void %s_cat(char **b, size_t *l, size_t *m, const char *x, size_t n) {\n"
+      "  if (*b == NULL || *l + n + 1 > *m) {\n"
+      "    *m = (*l + n + 1) * 2;\n"
+      "    *b = realloc(*b, *m);\n"
+      "  }\n"
+      "  memcpy(*b + *l, x, n);\n"
+      "  *l += n;\n"
+      "  (*b)[*l] = '\\0';\n"
+      "}\n\n", n);
+  }
+
+  sprintf(use, "%.40s_push(", n);
+  if (strstr(code, use)) {
+    fprintf(f,
+      "static void %s_push(mpc_val_t ***xs, int *n, int *m, mpc_val_t **s, mpc_val_t *x) {\n"
+      "  if (*n == *m) {\n"
+      "    *m *= 2;\n"
+      "    if (*xs == s) {\n"
+      "      *xs = malloc(sizeof(mpc_val_t*) * *m);\n"
+      "      memcpy(*xs, s, sizeof(mpc_val_t*) * *n);\n"
+      "    } else {\n"
+      "      *xs = realloc(*xs, sizeof(mpc_val_t*) * *m);\n"
+      "    }\n"
+      "  }\n"
+      "  (*xs)[(*n)++] = x;\n"
+      "}\n\n", n);
+  }
+}
+
+static int mpc_gen_is_rule(mpc_gen_t *g, int j) {
+  return j == 0 || g->t.nodes[j]->retained;
+}
+
+mpc_err_t *mpca_codegen(FILE *f, const char *name, mpc_parser_t *p) {
+
+  int j, x;
+  mpc_gen_t g;
+  mpc_parser_t *q;
+  mpc_err_t *err = NULL;
+
+  memset(&g, 0, sizeof(mpc_gen_t));
+  g.name = name;
+  mpc_table_collect(&g.t, p);
+
+  for (j = 0; j < g.t.nodes_num; j++) {
+
+    if (!mpc_gen_is_rule(&g, j)) { continue; }
+    q = g.t.nodes[j];
+
+    if (q->name && !strstr(q->name, "*/")) { mpc_gen_line(&g, "/* %s */", q->name); }
+    mpc_gen_line(&g, "static int %s_%d(%s_ctx_t *c, mpc_val_t **o, long *e, int depth) {", name, j, name);
+    g.indent++;
+    g.vars = 0;
+    x = mpc_gen_node(&g, q, 0, 1);
+    mpc_gen_line(&g, "*o = v%d;", x);
+    mpc_gen_line(&g, "*e = e%d;", x);
+    mpc_gen_line(&g, "return ok%d;", x);
+    g.indent--;
+    mpc_gen_line(&g, "}");
+    mpc_gen_line(&g, "");
+  }
+
+  if (g.t.bad) {
+    err = mpc_err_file("<mpca_codegen>", g.t.bad);
+  } else {
+
+    mpc_gen_prelude(f, name, g.code.s);
+    if (g.data.s) { fprintf(f, "%s\n", g.data.s); }
+
+    for (j = 0; j < g.t.nodes_num; j++) {
+      if (!mpc_gen_is_rule(&g, j)) { continue; }
+      fprintf(f, "static int %s_%d(%s_ctx_t *c, mpc_val_t **o, long *e, int depth);\n", name, j, name);
+    }
+    fprintf(f, "\n%s", g.code.s);
+
+    fprintf(f,
+      "static int %s(const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r, int arena) {\n"
+      "  %s_ctx_t c;\n"
+      "  mpc_val_t *v = NULL;\n"
+      "  long e = -1;\n"
+      "  c.s = string; c.pos = 0; c.term = 0; c.bt = 1; c.sup = 0;\n"
+      "  c.rpos = 0; c.row = 0; c.col = 0;\n"
+      "  c.max = MPC_MAX_RECURSION_DEPTH;\n"
+      "  c.arena = arena ? mpc_arena_new() : NULL;\n"
+      "  if (%s_0(&c, &v, &e, 0)) {\n"
+      "    if (c.arena) { mpc_arena_done(c.arena, v); }\n"
+      "    r->output = v;\n"
+      "    return 1;\n"
+      "  }\n"
+      "  if (c.arena) { mpc_arena_done(c.arena, NULL); }\n"
+      "  return arena ? mpc_parse_arena(filename, string, p, r) : mpc_parse(filename, string, p, r);\n"
+      "}\n", name, name, name);
+  }
+
+  free(g.t.s);
+  free(g.t.nodes);
+  free(g.data.s);
+  free(g.code.s);
+  return err;
+}
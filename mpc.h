@@ -65,12 +65,36 @@ typedef union {
 struct mpc_parser_t;
 typedef struct mpc_parser_t mpc_parser_t;
 
+/*
+** A parse first runs without building errors, and
+** only if it fails runs again from the start to
+** build them. Functions given to `mpc_apply`,
+** `mpc_apply_to`, `mpc_check`, `mpc_check_with`
+** and folds are then called twice for the same
+** input, and a failing parse takes longer than a
+** single run. Pipes are always parsed once, and a
+** context set with `mpc_context_set_lazy(c, 0)`
+** parses once building errors as it goes.
+*/
+
 int mpc_parse(const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r);
 int mpc_nparse(const char *filename, const char *string, size_t length, mpc_parser_t *p, mpc_result_t *r);
 int mpc_parse_file(const char *filename, FILE *file, mpc_parser_t *p, mpc_result_t *r);
 int mpc_parse_pipe(const char *filename, FILE *pipe, mpc_parser_t *p, mpc_result_t *r);
 int mpc_parse_contents(const char *filename, mpc_parser_t *p, mpc_result_t *r);
 
+#define MPC_MAX_RECURSION_DEPTH 1000
+
+struct mpc_context_t;
+typedef struct mpc_context_t mpc_context_t;
+
+mpc_context_t *mpc_context_new(void);
+void mpc_context_set_max_depth(mpc_context_t *c, int depth);
+void mpc_context_set_lazy(mpc_context_t *c, int lazy);
+void mpc_context_delete(mpc_context_t *c);
+int mpc_context_parse(mpc_context_t *c, const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r);
+int mpc_context_parse_arena(mpc_context_t *c, const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r);
+
 /*
 ** Function Types
 */
@@ -281,12 +305,17 @@ mpc_parser_t *mpc_re_mode(const char *re, int mode);
 ** AST
 */
 
+struct mpc_arena_t;
+typedef struct mpc_arena_t mpc_arena_t;
+
 typedef struct mpc_ast_t {
   char *tag;
   char *contents;
   mpc_state_t state;
   int children_num;
   struct mpc_ast_t** children;
+  int tag_id;
+  mpc_arena_t *arena;
 } mpc_ast_t;
 
 mpc_ast_t *mpc_ast_new(const char *tag, const char *contents);
@@ -299,6 +328,11 @@ mpc_ast_t *mpc_ast_tag(mpc_ast_t *a, const char *t);
 mpc_ast_t *mpc_ast_state(mpc_ast_t *a, mpc_state_t s);
 
 void mpc_ast_delete(mpc_ast_t *a);
+
+mpc_arena_t *mpc_arena_new(void);
+mpc_ast_t *mpc_arena_ast_new(mpc_arena_t *m, const char *tag, const char *contents);
+void mpc_arena_done(mpc_arena_t *m, mpc_ast_t *a);
+int mpc_parse_arena(const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r);
 void mpc_ast_print(mpc_ast_t *a);
 void mpc_ast_print_to(mpc_ast_t *a, FILE *fp);
 
@@ -364,6 +398,20 @@ mpc_err_t *mpca_lang_file(int flags, FILE *f, ...);
 mpc_err_t *mpca_lang_pipe(int flags, FILE *f, ...);
 mpc_err_t *mpca_lang_contents(int flags, const char *filename, ...);
 
+/*
+** Grammar Tables
+*/
+
+mpc_err_t *mpca_table(const void *table, size_t length, int n, ...);
+mpc_err_t *mpca_table_write(FILE *f, int n, ...);
+mpc_err_t *mpca_table_source(FILE *f, const char *name, int n, ...);
+
+/*
+** Code Generation
+*/
+
+mpc_err_t *mpca_codegen(FILE *f, const char *name, mpc_parser_t *p);
+
 /*
 ** Misc
 */
@@ -371,6 +419,16 @@ mpc_err_t *mpca_lang_contents(int flags, const char *filename, ...);
 
 void mpc_print(mpc_parser_t *p);
 void mpc_optimise(mpc_parser_t *p);
+
+/*
+** Freezing a parser and all it runs makes
+** `mpc_define` delete its argument and return NULL
+** and `mpc_optimise` do nothing for them, so the
+** grammar can be parsed with from many threads.
+** They can still be undefined and deleted.
+*/
+void mpc_freeze(mpc_parser_t *p);
+
 void mpc_stats(mpc_parser_t *p);
 
 int mpc_test_pass(mpc_parser_t *p, const char *s, const void *d,